@@ -0,0 +1,77 @@
+#!/usr/bin/perl
+
+# packs a directory into an uncompressed asset bundle (see ggl/bundle.h)
+
+use strict;
+use File::Find;
+
+die "$0 <dir> <bundle>" if @ARGV != 2;
+
+my ($dir, $bundle) = @ARGV;
+
+use constant ALIGNMENT => 16;
+use constant HEADER_SIZE => 12;
+use constant TOC_ENTRY_SIZE => 16;
+
+# collect files, sorted bytewise like strcmp
+
+my @names;
+
+find({ wanted => sub { push @names, $File::Find::name =~ s{^\Q$dir\E/}{}r if -f }, no_chdir => 1 }, $dir);
+
+@names = sort { $a cmp $b } @names;
+
+# lay out names, then data
+
+my $names_offset = HEADER_SIZE + @names*TOC_ENTRY_SIZE;
+
+my ($names, @toc);
+
+for my $name (@names) {
+	push @toc, { name_offset => $names_offset + length($names), name_size => length($name) };
+	$names .= "$name\0";
+}
+
+my $offset = $names_offset + length($names);
+
+sub pad { my $n = shift; return (ALIGNMENT - $n % ALIGNMENT) % ALIGNMENT; }
+
+$offset += pad($offset);
+
+for my $i (0 .. $#names) {
+	my $size = -s "$dir/$names[$i]";
+
+	$toc[$i]{data_offset} = $offset;
+	$toc[$i]{data_size} = $size;
+
+	# at least one NUL after each entry, so text assets can be used in place
+	$offset += $size + 1;
+	$offset += pad($offset);
+}
+
+# write it
+
+open OUT, '>', $bundle or die "failed to open $bundle: $!";
+binmode OUT;
+
+print OUT 'GGLB', pack('V V', 1, scalar @names);
+
+print OUT pack('V V V V', @$_{qw(name_offset name_size data_offset data_size)}) for @toc;
+
+print OUT $names;
+
+for my $i (0 .. $#names) {
+	print OUT "\0" x ($toc[$i]{data_offset} - tell OUT);
+
+	open IN, '<', "$dir/$names[$i]" or die "failed to open $names[$i]: $!";
+	binmode IN;
+	local $/;
+	print OUT <IN>;
+	close IN;
+
+	print OUT "\0";
+}
+
+print OUT "\0" x ($offset - tell OUT);
+
+close OUT;
@@ -87,18 +87,16 @@ close OBJ;
 
 $_ = $_->versor for @vnormals;
 
-print pack 'C4', ord('M'), ord('E'), ord('S'), ord('H');
+# version 2 (see ggl/mesh.cc): header, then vertex and index blobs in the
+# layout they're uploaded in
 
-print pack 'S', scalar @verts;
+print pack 'C4 V3', ord('M'), ord('S'), ord('H'), ord('2'), scalar @verts, 3*@tris, 0;
 
 for (@verts) {
-	my $p = $pos[$_->{pos}];
-
-	print pack 'f3', @{$pos[$_->{pos}]};
-	print pack 'f3', @{$normals[$_->{normal}]};
-	print pack 'f3', @{$vnormals[$_->{pos}]};
-	print pack 'f3', @{$materials{$_->{material}}->{Kd}};
+	print pack 'f<3', @{$pos[$_->{pos}]};
+	print pack 'f<3', @{$normals[$_->{normal}]};
+	print pack 'f<3', @{$vnormals[$_->{pos}]};
+	print pack 'f<3', @{$materials{$_->{material}}->{Kd}};
 }
 
-print pack 'S', scalar @tris;
-print pack 'S3', @{$_->{verts}} for @tris;
+print pack 'v3', @{$_->{verts}} for @tris;
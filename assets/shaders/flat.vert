@@ -1,4 +1,7 @@
-uniform mat4 proj_modelview;
+layout(std140, row_major) uniform transforms {
+	mat4 proj_modelview; // ortho
+	mat4 proj_matrix; // perspective
+};
 
 layout(location=0) in vec2 position;
 
@@ -0,0 +1,15 @@
+uniform int id_base;
+
+layout(location=0) out vec4 out_color;
+layout(location=1) out vec4 out_id;
+
+in vec4 frag_color;
+flat in int frag_instance;
+
+void main(void)
+{
+	out_color = frag_color;
+
+	// 0 is the background; ids wrap around, so only meshes 255 apart collide
+	out_id = vec4(float((id_base + frag_instance)%255 + 1)/255., 0., 0., 1.);
+}
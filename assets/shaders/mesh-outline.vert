@@ -1,13 +1,22 @@
-uniform mat4 proj_matrix;
-uniform mat4 modelview_matrix;
+layout(std140, row_major) uniform transforms {
+	mat4 proj_modelview; // ortho
+	mat4 proj_matrix; // perspective
+};
 
 uniform float offs;
 
 layout(location=0) in vec3 position;
 layout(location=2) in vec3 normal;
 
+// per instance
+layout(location=4) in vec4 modelview_row0;
+layout(location=5) in vec4 modelview_row1;
+layout(location=6) in vec4 modelview_row2;
+
 void main(void)
 {
+	mat4 modelview_matrix = transpose(mat4(modelview_row0, modelview_row1, modelview_row2, vec4(0., 0., 0., 1.)));
+
 	vec3 p = position + offs*normal;
 	gl_Position = proj_matrix*modelview_matrix*vec4(p, 1.);
 }
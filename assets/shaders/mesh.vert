@@ -1,17 +1,27 @@
-uniform mat4 proj_matrix;
-uniform mat4 modelview_matrix;
+layout(std140, row_major) uniform transforms {
+	mat4 proj_modelview; // ortho
+	mat4 proj_matrix; // perspective
+};
 
 layout(location=0) in vec3 position;
 layout(location=1) in vec3 normal;
 layout(location=2) in vec3 vnormal;
 layout(location=3) in vec3 color;
 
+// per instance
+layout(location=4) in vec4 modelview_row0;
+layout(location=5) in vec4 modelview_row1;
+layout(location=6) in vec4 modelview_row2;
+
 out vec4 frag_color;
+flat out int frag_instance; // for mesh-id.frag
 
 const vec3 light = normalize(vec3(1., 1., 1.));
 
 void main(void)
 {
+	mat4 modelview_matrix = transpose(mat4(modelview_row0, modelview_row1, modelview_row2, vec4(0., 0., 0., 1.)));
+
 	vec3 n = normalize(modelview_matrix*vec4(normal, 0.)).xyz;
 
 	float l = dot(n, light);
@@ -22,4 +32,6 @@ void main(void)
 
 	// ADVANCED LIGHTING MODEL
 	frag_color = vec4(vec3(.1, .1, .1) + l*color + l*l*l*vec3(1., 1., 1.), 1.);
+
+	frag_instance = gl_InstanceID;
 }
@@ -0,0 +1,30 @@
+uniform sampler2D source_buffer;
+uniform sampler2D id_buffer;
+
+uniform vec2 resolution;
+uniform float width;
+uniform vec4 color;
+
+in vec2 frag_texcoord;
+out vec4 out_color;
+
+void main(void)
+{
+	vec2 d = width/resolution;
+
+	float id = texture(id_buffer, frag_texcoord).r;
+
+	// edge if any neighbour belongs to a different mesh. background
+	// neighbours (id 0) don't count, so the outline grows outwards like
+	// the geometry outline does
+	float edge = 0.;
+
+	for (int i = -1; i <= 1; i++) {
+		for (int j = -1; j <= 1; j++) {
+			float n = texture(id_buffer, frag_texcoord + vec2(float(i), float(j))*d).r;
+			edge = max(edge, step(.5/255., n)*step(.5/255., abs(n - id)));
+		}
+	}
+
+	out_color = mix(texture(source_buffer, frag_texcoord), color, edge);
+}
@@ -0,0 +1,24 @@
+layout(std140, row_major) uniform transforms {
+	mat4 proj_modelview; // ortho
+	mat4 proj_matrix; // perspective
+};
+
+layout(location=0) in vec2 corner; // unit quad
+
+// per instance
+layout(location=1) in vec2 origin;
+layout(location=2) in vec2 axis_s;
+layout(location=3) in vec2 axis_t;
+layout(location=4) in vec4 tex_rect; // min, max
+layout(location=5) in vec4 color;
+
+out vec2 frag_texcoord;
+out vec4 frag_color;
+
+void main(void)
+{
+	vec2 position = origin + corner.s*axis_s + corner.t*axis_t;
+	gl_Position = proj_modelview*vec4(position, 0., 1.);
+	frag_texcoord = mix(tex_rect.xy, tex_rect.zw, corner);
+	frag_color = color;
+}
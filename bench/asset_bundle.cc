@@ -0,0 +1,151 @@
+// times reading the game's assets through PhysFS from assets.zip against
+// reading them from the mapped assets.bundle (see ggl/bundle.h). run from
+// the game's build directory:
+//
+//   bench_asset_bundle [assets.zip [assets.bundle [runs]]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <physfs.h>
+
+#include <ggl/panic.h>
+#include <ggl/asset.h>
+#include <ggl/bundle.h>
+#include <ggl/sdl/asset.h>
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+// loaded when a level starts; everything else is loaded at startup
+const char *LEVEL_DIRS[] = { "images", "meshes" };
+
+struct asset_set
+{
+	const char *name;
+	std::vector<std::string> paths;
+};
+
+void
+list_files(const std::string& dir, std::vector<std::string>& paths)
+{
+	char **names = PHYSFS_enumerateFiles(dir.c_str());
+
+	for (char **p = names; *p; ++p) {
+		const std::string path = dir.empty() ? *p : dir + "/" + *p;
+
+		if (PHYSFS_isDirectory(path.c_str()))
+			list_files(path, paths);
+		else
+			paths.push_back(path);
+	}
+
+	PHYSFS_freeList(names);
+}
+
+bool
+is_level_asset(const std::string& path)
+{
+	for (auto dir : LEVEL_DIRS) {
+		if (path.compare(0, path.find('/'), dir) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+double
+elapsed_us(bench_clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+}
+
+// both sides read each asset the way the engine reads text assets, with
+// read_text(): a copy (and inflate) for PhysFS, the mapping itself for
+// the bundle. opening the archive is part of the time
+
+double
+time_zip(const char *zip_path, const asset_set& set, int runs, size_t& sink)
+{
+	const auto start = bench_clock::now();
+
+	for (int i = 0; i < runs; i++) {
+		if (!PHYSFS_mount(zip_path, nullptr, 1))
+			panic("failed to mount `%s': %s", zip_path, PHYSFS_getLastError());
+
+		for (auto& path : set.paths) {
+			ggl::sdl::asset a { path };
+			sink += a.read_text()[0] + a.size();
+		}
+
+		PHYSFS_removeFromSearchPath(zip_path);
+	}
+
+	return elapsed_us(start)/runs;
+}
+
+double
+time_bundle(const char *bundle_path, const asset_set& set, int runs, size_t& sink)
+{
+	const auto start = bench_clock::now();
+
+	for (int i = 0; i < runs; i++) {
+		ggl::bundle b { bundle_path };
+
+		for (auto& path : set.paths) {
+			auto a = b.get_asset(path);
+
+			if (!a)
+				panic("`%s' isn't in %s", path.c_str(), bundle_path);
+
+			sink += a->read_text()[0] + a->size();
+		}
+	}
+
+	return elapsed_us(start)/runs;
+}
+
+} // (anonymous namespace)
+
+int
+main(int argc, char *argv[])
+{
+	const char *zip_path = argc > 1 ? argv[1] : "assets.zip";
+	const char *bundle_path = argc > 2 ? argv[2] : "assets.bundle";
+	const int runs = argc > 3 ? atoi(argv[3]) : 20;
+
+	if (!PHYSFS_init(argv[0]))
+		panic("PHYSFS_init: %s", PHYSFS_getLastError());
+
+	if (!PHYSFS_mount(zip_path, nullptr, 1))
+		panic("failed to mount `%s': %s", zip_path, PHYSFS_getLastError());
+
+	std::vector<std::string> paths;
+	list_files("", paths);
+
+	PHYSFS_removeFromSearchPath(zip_path);
+
+	asset_set startup { "startup", {} }, level { "level", {} };
+
+	for (auto& path : paths)
+		(is_level_asset(path) ? level : startup).paths.push_back(path);
+
+	size_t sink = 0;
+
+	printf("%-8s %6s %12s %12s\n", "set", "files", "zip (us)", "bundle (us)");
+
+	for (auto set : { &startup, &level }) {
+		const double zip_us = time_zip(zip_path, *set, runs, sink);
+		const double bundle_us = time_bundle(bundle_path, *set, runs, sink);
+
+		printf("%-8s %6zu %12.0f %12.0f\n", set->name, set->paths.size(), zip_us, bundle_us);
+	}
+
+	fprintf(stderr, "(%zu)\n", sink);
+
+	PHYSFS_deinit();
+}
@@ -0,0 +1,174 @@
+// times decoding the game's meshes one value at a time through the asset
+// read_* calls against decoding them in bulk with asset_reader, as
+// mesh::load does. meshes come from assets.zip through PhysFS and from the
+// mapped assets.bundle. nothing is uploaded to the GL. run from the game's
+// build directory:
+//
+//   bench_mesh_load [assets.zip [assets.bundle [runs]]]
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <physfs.h>
+
+#include <ggl/panic.h>
+#include <ggl/asset.h>
+#include <ggl/asset_reader.h>
+#include <ggl/bundle.h>
+#include <ggl/sdl/asset.h>
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+const char *MESHES[] = { "meshes/boss.msh", "meshes/pod.msh", "meshes/miniboss.msh" };
+
+const uint32_t MESH_V1_MAGIC = 'M' | ('E' << 8) | ('S' << 16) | ('H' << 24);
+const uint32_t MESH_V2_MAGIC = 'M' | ('S' << 8) | ('H' << 16) | ('2' << 24);
+
+const size_t VERTEX_FLOATS = 12; // position, normal, vnormal, color
+
+struct mesh_data
+{
+	std::vector<float> vertex_data;
+	std::vector<uint16_t> index_data;
+};
+
+// same layout handling as mesh::load, minus the checks
+
+void
+decode_per_value(ggl::asset& a, mesh_data& m)
+{
+	size_t num_verts, num_indices;
+
+	const uint32_t sig = a.read_uint32();
+
+	if (sig == MESH_V2_MAGIC) {
+		num_verts = a.read_uint32();
+		num_indices = a.read_uint32();
+		a.read_uint32();
+	} else if (sig == MESH_V1_MAGIC) {
+		num_verts = a.read_uint16();
+		num_indices = 0;
+	} else {
+		panic("not a mesh");
+	}
+
+	m.vertex_data.resize(num_verts*VERTEX_FLOATS);
+
+	for (auto& v : m.vertex_data)
+		v = a.read_float();
+
+	if (sig == MESH_V1_MAGIC)
+		num_indices = 3*a.read_uint16();
+
+	m.index_data.resize(num_indices);
+
+	for (auto& i : m.index_data)
+		i = a.read_uint16();
+}
+
+void
+decode_bulk(ggl::asset& a, mesh_data& m)
+{
+	ggl::asset_reader r { a };
+
+	size_t num_verts, num_indices;
+
+	const uint32_t sig = r.read_uint32();
+
+	if (sig == MESH_V2_MAGIC) {
+		num_verts = r.read_uint32();
+		num_indices = r.read_uint32();
+		r.read_uint32();
+	} else if (sig == MESH_V1_MAGIC) {
+		num_verts = r.read_uint16();
+		num_indices = 0;
+	} else {
+		panic("not a mesh");
+	}
+
+	m.vertex_data.resize(num_verts*VERTEX_FLOATS);
+	r.read_float(m.vertex_data.data(), m.vertex_data.size());
+
+	if (sig == MESH_V1_MAGIC)
+		num_indices = 3*r.read_uint16();
+
+	m.index_data.resize(num_indices);
+	r.read_uint16(m.index_data.data(), m.index_data.size());
+}
+
+template <typename OpenAsset>
+double
+time_decode(OpenAsset open_asset, void (*decode)(ggl::asset&, mesh_data&), int runs, size_t& sink)
+{
+	const auto start = bench_clock::now();
+
+	for (int i = 0; i < runs; i++) {
+		mesh_data m;
+		decode(*open_asset(), m);
+		sink += m.vertex_data.size() + m.index_data.size();
+	}
+
+	return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count()/runs;
+}
+
+} // (anonymous namespace)
+
+int
+main(int argc, char *argv[])
+{
+	const char *zip_path = argc > 1 ? argv[1] : "assets.zip";
+	const char *bundle_path = argc > 2 ? argv[2] : "assets.bundle";
+	const int runs = argc > 3 ? atoi(argv[3]) : 500;
+
+	if (!PHYSFS_init(argv[0]))
+		panic("PHYSFS_init: %s", PHYSFS_getLastError());
+
+	if (!PHYSFS_mount(zip_path, nullptr, 1))
+		panic("failed to mount `%s': %s", zip_path, PHYSFS_getLastError());
+
+	ggl::bundle b { bundle_path };
+
+	size_t sink = 0;
+
+	printf("%-22s %-7s %12s %12s\n", "mesh", "source", "value (us)", "bulk (us)");
+
+	for (auto path : MESHES) {
+		if (!PHYSFS_exists(path)) {
+			printf("%-22s (not in %s)\n", path, zip_path);
+			continue;
+		}
+
+		auto open_zip = [&]
+			{
+				return std::unique_ptr<ggl::asset>(new ggl::sdl::asset(path));
+			};
+
+		auto open_bundle = [&]
+			{
+				auto a = b.get_asset(path);
+
+				if (!a)
+					panic("`%s' isn't in %s", path, bundle_path);
+
+				return a;
+			};
+
+		printf("%-22s %-7s %12.1f %12.1f\n", path, "zip",
+		  time_decode(open_zip, decode_per_value, runs, sink),
+		  time_decode(open_zip, decode_bulk, runs, sink));
+
+		printf("%-22s %-7s %12.1f %12.1f\n", path, "bundle",
+		  time_decode(open_bundle, decode_per_value, runs, sink),
+		  time_decode(open_bundle, decode_bulk, runs, sink));
+	}
+
+	fprintf(stderr, "(%zu)\n", sink);
+
+	PHYSFS_deinit();
+}
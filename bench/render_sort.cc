@@ -0,0 +1,148 @@
+// times the render queue sort (ggl::key_sorter) against std::stable_sort,
+// which the renderer used before, on queues of 1k, 10k and 50k primitives:
+//
+//   bench_render_sort [runs]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <ggl/key_sorter.h>
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+const size_t QUEUE_SIZES[] = { 1000, 10000, 50000 };
+
+// same key layout as the renderer: depth, primitive type, material id
+
+uint64_t
+make_key(float depth, unsigned type, unsigned material_id)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof bits);
+	bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+	return (static_cast<uint64_t>(bits) << 32) | (static_cast<uint64_t>(type) << 31) | material_id;
+}
+
+// what the game queues: entities, particles and widgets drawn at depths 0,
+// 1 and 2, in runs sharing a texture, with the odd mesh
+
+std::vector<ggl::sort_entry>
+make_game_queue(size_t size, std::mt19937& rng)
+{
+	static const float depths[] = { 0, 0, 0, 1, 1, 2 };
+
+	std::vector<ggl::sort_entry> queue;
+
+	while (queue.size() < size) {
+		const float depth = depths[rng() % 6];
+		const unsigned type = rng() % 10 == 0;
+		const unsigned material_id = rng() % 8;
+
+		const size_t run = 1 + rng() % 32;
+
+		for (size_t i = 0; i < run && queue.size() < size; i++)
+			queue.push_back({ make_key(depth, type, material_id), static_cast<uint32_t>(queue.size()) });
+	}
+
+	return queue;
+}
+
+// worst case: a different depth for every primitive
+
+std::vector<ggl::sort_entry>
+make_distinct_queue(size_t size, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> depth(0, 10);
+
+	std::vector<ggl::sort_entry> queue;
+
+	for (size_t i = 0; i < size; i++)
+		queue.push_back({ make_key(depth(rng), 0, rng() % 8), static_cast<uint32_t>(i) });
+
+	return queue;
+}
+
+template <typename Sort>
+double
+time_sort(const std::vector<ggl::sort_entry>& queue, Sort sort, int runs, std::vector<ggl::sort_entry>& sorted)
+{
+	double best = 0;
+
+	for (int i = 0; i < runs; i++) {
+		sorted = queue;
+
+		const auto start = bench_clock::now();
+		sort(sorted);
+		const double us = std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+
+		if (i == 0 || us < best)
+			best = us;
+	}
+
+	return best;
+}
+
+} // (anonymous namespace)
+
+int
+main(int argc, char *argv[])
+{
+	const int runs = argc > 1 ? atoi(argv[1]) : 200;
+
+	std::mt19937 rng { 1 };
+
+	ggl::key_sorter sorter;
+
+	auto stable_sort = [](std::vector<ggl::sort_entry>& entries)
+		{
+			std::stable_sort(
+				std::begin(entries),
+				std::end(entries),
+				[](const ggl::sort_entry& a, const ggl::sort_entry& b)
+				{
+					return a.key < b.key;
+				});
+		};
+
+	auto key_sort = [&](std::vector<ggl::sort_entry>& entries)
+		{
+			sorter.sort(entries);
+		};
+
+	struct {
+		const char *name;
+		std::vector<ggl::sort_entry> (*make_queue)(size_t, std::mt19937&);
+	} distributions[] = {
+		{ "game", make_game_queue },
+		{ "distinct", make_distinct_queue } };
+
+	printf("%-9s %6s %18s %18s\n", "keys", "size", "stable_sort (us)", "key_sorter (us)");
+
+	for (auto& d : distributions) {
+		for (auto size : QUEUE_SIZES) {
+			const auto queue = d.make_queue(size, rng);
+
+			std::vector<ggl::sort_entry> expected, sorted;
+
+			const double stable_us = time_sort(queue, stable_sort, runs, expected);
+			const double key_us = time_sort(queue, key_sort, runs, sorted);
+
+			for (size_t i = 0; i < size; i++) {
+				if (sorted[i].index != expected[i].index) {
+					fprintf(stderr, "%s %zu: orders differ at %zu\n", d.name, size, i);
+					return 1;
+				}
+			}
+
+			printf("%-9s %6zu %18.1f %18.1f\n", d.name, size, stable_us, key_us);
+		}
+	}
+}
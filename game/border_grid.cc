@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cmath>
+
+#include "level.h"
+#include "border_grid.h"
+
+void
+border_grid::reset(int grid_cols, int grid_rows)
+{
+	// border verts go from 0 to grid_cols/grid_rows inclusive
+
+	bucket_cols_ = grid_cols/BUCKET_CELLS + 1;
+	bucket_rows_ = grid_rows/BUCKET_CELLS + 1;
+
+	buckets_.resize(bucket_cols_*bucket_rows_);
+
+	for (auto& b : buckets_)
+		b.clear();
+}
+
+void
+border_grid::add_edge(size_t index, const vec2i& v0, const vec2i& v1)
+{
+	const int c0 = std::min(v0.x, v1.x)/BUCKET_CELLS;
+	const int c1 = std::max(v0.x, v1.x)/BUCKET_CELLS;
+
+	const int r0 = std::min(v0.y, v1.y)/BUCKET_CELLS;
+	const int r1 = std::max(v0.y, v1.y)/BUCKET_CELLS;
+
+	for (int r = r0; r <= r1; r++) {
+		for (int c = c0; c <= c1; c++)
+			buckets_[r*bucket_cols_ + c].push_back(index);
+	}
+}
+
+void
+border_grid::find_edges(const vec2f& center, float radius, std::vector<size_t>& edges) const
+{
+	edges.clear();
+
+	const float bucket_size = BUCKET_CELLS*CELL_SIZE;
+
+	auto clamp = [](int v, int max) { return std::max(0, std::min(v, max - 1)); };
+
+	const int c0 = clamp(floorf((center.x - radius)/bucket_size), bucket_cols_);
+	const int c1 = clamp(floorf((center.x + radius)/bucket_size), bucket_cols_);
+
+	const int r0 = clamp(floorf((center.y - radius)/bucket_size), bucket_rows_);
+	const int r1 = clamp(floorf((center.y + radius)/bucket_size), bucket_rows_);
+
+	for (int r = r0; r <= r1; r++) {
+		for (int c = c0; c <= c1; c++) {
+			auto& b = buckets_[r*bucket_cols_ + c];
+			edges.insert(std::end(edges), std::begin(b), std::end(b));
+		}
+	}
+
+	// long edges span several buckets
+
+	std::sort(std::begin(edges), std::end(edges));
+	edges.erase(std::unique(std::begin(edges), std::end(edges)), std::end(edges));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <ggl/vec2.h>
+
+// uniform grid over the border edges, so foes only test the edges near them
+
+class border_grid
+{
+public:
+	void reset(int grid_cols, int grid_rows);
+
+	// v0, v1 in grid cells
+	void add_edge(size_t index, const vec2i& v0, const vec2i& v1);
+
+	// indices of edges in buckets overlapping the circle (in world coordinates), each listed once
+	void find_edges(const vec2f& center, float radius, std::vector<size_t>& edges) const;
+
+private:
+	static const int BUCKET_CELLS = 8;
+
+	int bucket_cols_, bucket_rows_;
+	std::vector<std::vector<size_t>> buckets_;
+};
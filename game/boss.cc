@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include <algorithm>
+#include <limits>
 
 #include <ggl/vec2_util.h>
 #include <ggl/texture.h>
@@ -15,20 +16,25 @@
 
 #include "game.h"
 #include "debuggfx.h"
+#include "object_pool.h"
 #include "boss.h"
 
 namespace {
 
-class bullet : public entity
+class bullet final : public entity
 {
 public:
 	bullet(game& g, const vec2f& pos, const vec2f& dir);
 
+	static void *operator new(size_t size);
+	static void operator delete(void *p);
+
 	void draw() const override;
 	bool update() override;
 
 	bool intersects(const vec2i& from, const vec2i& to) const override;
 	bool intersects(const vec2i& center, float radius) const override;
+	bool get_bounds(ggl::bbox& bounds) const override;
 
 private:
 	static const int LENGTH = 32;
@@ -38,6 +44,21 @@ private:
 	const ggl::sprite *sprite_;
 };
 
+object_pool<bullet> bullet_pool;
+
+void *
+bullet::operator new(size_t size)
+{
+	assert(size == sizeof(bullet));
+	return bullet_pool.allocate();
+}
+
+void
+bullet::operator delete(void *p)
+{
+	bullet_pool.deallocate(p);
+}
+
 bullet::bullet(game& g, const vec2f& pos, const vec2f& dir)
 : entity { g }
 , pos_ { pos }
@@ -118,6 +139,18 @@ bullet::intersects(const vec2i& center, float radius) const
 	return distance(seg_closest_point(pos_, end, center), vec2f(center)) < radius;
 }
 
+bool
+bullet::get_bounds(ggl::bbox& bounds) const
+{
+	vec2f end = pos_ + dir_*static_cast<float>(LENGTH);
+
+	bounds = {
+		{ std::min(pos_.x, end.x), std::min(pos_.y, end.y) },
+		{ std::max(pos_.x, end.x), std::max(pos_.y, end.y) } };
+
+	return true;
+}
+
 // pod formations
 
 const float POD_DISTANCE = 64;
@@ -158,6 +191,20 @@ boss::intersects_children(const vec2i& center, float radius) const
 	return false;
 }
 
+bool
+boss::get_bounds(ggl::bbox& bounds) const
+{
+	// lasers don't end, so while one is firing the whole grid is in range
+
+	if (std::any_of(std::begin(pods_), std::end(pods_), [](const std::unique_ptr<pod>& p) { return p->laser_active(); })) {
+		const float max = std::numeric_limits<float>::max();
+		bounds = { { -max, -max }, { max, max } };
+		return true;
+	}
+
+	return foe::get_bounds(bounds);
+}
+
 bool
 boss::update()
 {
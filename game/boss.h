@@ -26,6 +26,8 @@ public:
 	void fire_bullet(int pod);
 	void fire_laser(int pod, float power);
 
+	bool get_bounds(ggl::bbox& bounds) const override;
+
 	static const int RADIUS = 56;
 
 private:
@@ -52,6 +54,9 @@ private:
 
 		bool intersects(const vec2f& center, float angle, const vec2i& from, const vec2i& to) const;
 
+		bool laser_active() const
+		{ return laser_power_ != 0.f; }
+
 		float ang_offset;
 		float rotation;
 
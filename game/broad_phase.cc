@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstdint>
+
+#include "level.h"
+#include "broad_phase.h"
+
+namespace {
+
+bool
+overlaps(const ggl::bbox& a, const ggl::bbox& b)
+{
+	return !(a.max.x < b.min.x || a.min.x > b.max.x || a.max.y < b.min.y || a.min.y > b.max.y);
+}
+
+}
+
+broad_phase::broad_phase()
+: buckets_(NUM_BUCKETS)
+, query_stamp_ { 0 }
+, num_queries_ { 0 }
+, num_candidates_ { 0 }
+{ }
+
+void
+broad_phase::clear()
+{
+	entities_.clear();
+	large_entities_.clear();
+
+	for (auto& b : buckets_)
+		b.clear();
+
+	num_queries_ = num_candidates_ = 0;
+}
+
+broad_phase::bucket_range
+broad_phase::get_bucket_range(const ggl::bbox& box) const
+{
+	const float bucket_size = BUCKET_CELLS*CELL_SIZE;
+
+	return {
+		static_cast<int>(floorf(box.min.x/bucket_size)),
+		static_cast<int>(floorf(box.max.x/bucket_size)),
+		static_cast<int>(floorf(box.min.y/bucket_size)),
+		static_cast<int>(floorf(box.max.y/bucket_size)) };
+}
+
+std::vector<int>&
+broad_phase::get_bucket(int c, int r)
+{
+	const uint32_t h = (static_cast<uint32_t>(c)*73856093u) ^ (static_cast<uint32_t>(r)*19349663u);
+	return buckets_[h & (NUM_BUCKETS - 1)];
+}
+
+void
+broad_phase::add(entity *e, const ggl::bbox& bounds)
+{
+	const int index = entities_.size();
+	entities_.push_back({ e, bounds, query_stamp_ });
+
+	// upper bound on buckets touched, in floats since bounds may be huge
+
+	const float bucket_size = BUCKET_CELLS*CELL_SIZE;
+
+	const float cols = (bounds.max.x - bounds.min.x)/bucket_size + 2;
+	const float rows = (bounds.max.y - bounds.min.y)/bucket_size + 2;
+
+	if (cols*rows > MAX_ENTITY_BUCKETS) {
+		large_entities_.push_back(index);
+	} else {
+		const auto br = get_bucket_range(bounds);
+
+		for (int r = br.r0; r <= br.r1; r++) {
+			for (int c = br.c0; c <= br.c1; c++)
+				get_bucket(c, r).push_back(index);
+		}
+	}
+}
+
+void
+broad_phase::find(const ggl::bbox& box, std::vector<entity *>& result)
+{
+	result.clear();
+
+	++query_stamp_;
+
+	auto try_entity = [&](int index)
+		{
+			auto& en = entities_[index];
+
+			// buckets are shared by hash collisions, and big entities live in several of them
+
+			if (en.query_stamp != query_stamp_) {
+				en.query_stamp = query_stamp_;
+
+				if (overlaps(en.bounds, box))
+					result.push_back(en.e);
+			}
+		};
+
+	const auto br = get_bucket_range(box);
+
+	for (int r = br.r0; r <= br.r1; r++) {
+		for (int c = br.c0; c <= br.c1; c++) {
+			for (auto index : get_bucket(c, r))
+				try_entity(index);
+		}
+	}
+
+	for (auto index : large_entities_)
+		try_entity(index);
+
+	++num_queries_;
+	num_candidates_ += result.size();
+}
+
+unsigned
+broad_phase::get_skipped_tests() const
+{
+	return num_queries_*entities_.size() - num_candidates_;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include <ggl/render.h>
+
+class entity;
+
+// spatial hash of entity bounds, rebuilt every tick. lets collision checks
+// against the player trail skip entities that aren't anywhere near it.
+
+class broad_phase
+{
+public:
+	broad_phase();
+
+	void clear();
+	void add(entity *e, const ggl::bbox& bounds);
+
+	// entities whose bounds overlap box, each listed once
+	void find(const ggl::bbox& box, std::vector<entity *>& result);
+
+	// narrow-phase tests avoided since the last clear(), relative to testing every entity on every query
+	unsigned get_skipped_tests() const;
+
+private:
+	struct bucket_range
+	{
+		int c0, c1, r0, r1;
+	};
+	bucket_range get_bucket_range(const ggl::bbox& box) const;
+
+	std::vector<int>& get_bucket(int c, int r);
+
+	static const int BUCKET_CELLS = 4; // bucket size, in grid cells
+	static const int NUM_BUCKETS = 1024; // power of 2
+	static const int MAX_ENTITY_BUCKETS = 64; // bigger entities go to large_entities_
+
+	struct entry
+	{
+		entity *e;
+		ggl::bbox bounds;
+		unsigned query_stamp;
+	};
+
+	std::vector<entry> entities_;
+	std::vector<int> large_entities_;
+	std::vector<std::vector<int>> buckets_;
+
+	unsigned query_stamp_;
+	unsigned num_queries_;
+	unsigned num_candidates_;
+};
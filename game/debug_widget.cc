@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+#include <ggl/core.h>
+#include <ggl/resources.h>
+#include <ggl/font.h>
+#include <ggl/render.h>
+#include <ggl/gl_state.h>
+
+#include "game.h"
+#include "debug_widget.h"
+
+namespace {
+
+const float LINE_HEIGHT = 28;
+const int NUM_LINES = 8;
+const float LINE_WIDTH = 400; // roughly
+
+}
+
+debug_widget::debug_widget(game& g)
+: widget { g }
+, font_ { ggl::res::get_font("fonts/hud-small.spr") }
+{
+	using namespace std::placeholders;
+
+	pointer_down_conn_ =
+		ggl::g_core->get_pointer_down_event().connect(
+			std::bind(&debug_widget::on_pointer_down, this, _1, _2, _3));
+}
+
+bool
+debug_widget::update()
+{
+	return true;
+}
+
+void
+debug_widget::draw() const
+{
+	std::basic_stringstream<wchar_t> ss;
+
+	ss << "BG VERTS " << game_.get_background_span_vertex_count() << " -> " << game_.get_background_vertex_count() << "\n";
+	ss << "SKIPPED TESTS " << game_.get_skipped_collision_tests() << "\n";
+	ss << "DRAW CALLS " << ggl::render::get_draw_call_count() << "\n";
+	ss << "ELIDED GL CALLS " << ggl::gl_state::get_elided_call_count() << "\n";
+	ss << "OUTLINE " << (ggl::render::get_mesh_outline() == ggl::render::mesh_outline::GEOMETRY ? "GEOMETRY" : "POST") << "\n";
+
+	for (auto& usage : ggl::res::get_memory_usage()) {
+		std::string name { usage.manager };
+		std::transform(std::begin(name), std::end(name), std::begin(name), ::toupper);
+
+		ss << name.c_str() << " " << usage.count << " MEM " << usage.data_bytes/1024 << "K GL " << usage.gl_bytes/1024 << "K\n";
+	}
+
+	ggl::render::set_color({ 1, 1, 1, .75 });
+
+	vec2f pos { 8, game_.viewport_height - 8 };
+
+	std::wstring line;
+
+	while (std::getline(ss, line)) {
+		font_->draw(0, line, pos, ggl::vert_align::TOP, ggl::horiz_align::LEFT);
+		pos.y -= LINE_HEIGHT;
+	}
+}
+
+void
+debug_widget::on_pointer_down(int, float x, float y)
+{
+	// tapping the overlay switches between outline techniques, as does the
+	// key bound by the platform core. sy is measured from the top, like the
+	// overlay
+
+	auto core = ggl::g_core;
+
+	const float sx = x*static_cast<float>(game_.viewport_width)/core->get_viewport_width();
+	const float sy = y*static_cast<float>(game_.viewport_height)/core->get_viewport_height();
+
+	if (sx < LINE_WIDTH && sy < 8 + NUM_LINES*LINE_HEIGHT)
+		ggl::render::toggle_mesh_outline();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ggl/event.h>
+
+#include "widget.h"
+
+namespace ggl {
+class font;
+}
+
+class debug_widget : public widget
+{
+public:
+	debug_widget(game& g);
+
+	bool update() override;
+	void draw() const override;
+
+private:
+	void on_pointer_down(int pointer_id, float x, float y);
+
+	const ggl::font *font_;
+	ggl::event_connection_ptr pointer_down_conn_;
+};
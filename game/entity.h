@@ -5,6 +5,10 @@
 
 class game;
 
+namespace ggl {
+struct bbox;
+}
+
 class entity : private ggl::noncopyable
 {
 public:
@@ -17,6 +21,9 @@ public:
 	virtual bool intersects(const vec2i& from, const vec2i& to) const = 0;
 	virtual bool intersects(const vec2i& center, float radius) const = 0;
 
+	// world-space box containing everything intersects() can hit; false if it can't hit anything
+	virtual bool get_bounds(ggl::bbox& bounds) const = 0;
+
 protected:
 	game& game_;
 };
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <algorithm>
 
 #include <ggl/gl.h>
 #include <ggl/sprite.h>
@@ -7,6 +8,7 @@
 
 #include "util.h"
 #include "bezier.h"
+#include "particle_system.h"
 #include "explosion.h"
 
 namespace {
@@ -23,7 +25,9 @@ static const struct explosion_info {
 
 } // (anonymous namespace)
 
-explosion::explosion(const vec2f& pos, int bang)
+explosion::explosion(particle_system& ps, const vec2f& pos, int bang)
+: tics_ { 0 }
+, particles_ttl_ { 0 }
 {
 	assert(bang >= 0 && bang < sizeof explosion_infos/sizeof *explosion_infos);
 
@@ -31,9 +35,33 @@ explosion::explosion(const vec2f& pos, int bang)
 
 	const auto& info = explosion_infos[bang];
 
+	// streaks, pointing along their direction of motion
+
+	const auto st = ps.get_style(ggl::res::get_sprite("particle.png"), 0, 5, 32, -5, 0);
+
+	const bezier<rgb> gradient { { 1.f, .5f, 0.f }, { 1.f, 1.f, 0.f }, { 1.f, 1.f, 1.f } };
+
 	const int num_particles = rand<int>(info.min_particles, info.max_particles);
-	for (size_t i = 0; i < num_particles; i++)
-		particles_.emplace_back(particle_sprite_, pos);
+	for (size_t i = 0; i < num_particles; i++) {
+		const float a = rand<float>(0.f, 2.f*M_PI);
+		const int ttl = rand<int>(30, 50);
+
+		particle_system::particle_desc p;
+		p.pos = pos;
+		p.speed = rand<float>(3.2, 7.)*vec2f(cosf(a), sinf(a));
+		p.drag = .99f;
+		p.gravity = 0;
+		p.angle = a;
+		p.angle_speed = 0;
+		p.ttl = ttl;
+		p.fade_tics = 0;
+		p.color = gradient(rand<float>(0.f, 1.f));
+		p.st = st;
+
+		ps.spawn(p);
+
+		particles_ttl_ = std::max(particles_ttl_, ttl);
+	}
 
 	const int num_fireballs = rand<int>(info.min_fireballs, info.max_fireballs);
 	for (size_t i = 0; i < num_fireballs; i++) {
@@ -63,19 +91,12 @@ explosion::load_sprites()
 		sprintf(name, "explosion-%02d.png", i);
 		flare_sprites_[i] = ggl::res::get_sprite(name);
 	}
-
-	particle_sprite_ = ggl::res::get_sprite("particle.png");
 }
 
 bool
 explosion::do_update()
 {
-	bool rv = false;
-
-	for (auto& p : particles_) {
-		if (p.update())
-			rv = true;
-	}
+	bool rv = tics_++ < particles_ttl_;
 
 	for (auto& p : flares_) {
 		if (p.update())
@@ -88,72 +109,12 @@ explosion::do_update()
 void
 explosion::draw() const
 {
-	for (auto& p : particles_)
-		p.draw();
-
 	ggl::render::set_color(ggl::white);
 
 	for (auto& p : flares_)
 		p.draw();
 }
 
-// particles
-
-explosion::particle::particle(const ggl::sprite *sp, const vec2f& pos)
-: sp_ { sp }
-, pos_ { pos }
-, dir_ { [&] { float a = rand<float>(0.f, 2.f*M_PI); return vec2f(cosf(a), sinf(a)); }() }
-, tics_ { 0 }
-, ttl_ { rand<int>(30, 50) }
-, speed_ { rand<float>(3.2, 7.) }
-{
-	const bezier<rgb> gradient { { 1.f, .5f, 0.f }, { 1.f, 1.f, 0.f }, { 1.f, 1.f, 1.f } };
-	color_ = gradient(rand<float>(0.f, 1.f));
-}
-
-bool
-explosion::particle::update()
-{
-	if (tics_ >= ttl_)
-		return false;
-
-	++tics_;
-	pos_ += dir_*speed_;
-	speed_ *= .99f;
-
-	return true;
-}
-
-void
-explosion::particle::draw() const
-{
-	if (tics_ >= ttl_)
-		return;
-
-	// XXX
-	const int w = 32;
-	const int h = 10;
-
-	vec2f up = vec2f { -dir_.y, dir_.x }*.5f*h;
-	vec2f right = dir_*static_cast<float>(w);
-
-	const vec2f p0 = pos_ + up;
-	const vec2f p1 = pos_ - up;
-	const vec2f p2 = pos_ - up + right;
-	const vec2f p3 = pos_ + up + right;
-
-	const float u0 = sp_->u0;
-	const float u1 = sp_->u1;
-
-	const float v0 = sp_->v0;
-	const float v1 = sp_->v1;
-
-	float a = 1.f - static_cast<float>(tics_)/ttl_;
-	ggl::render::set_color({ color_.r, color_.g, color_.b, a });
-
-	ggl::render::draw(sp_->tex, { { u0, v1 }, { u1, v0 } }, ggl::quad { p0, p1, p2, p3 }, 0);
-}
-
 // flares
 
 explosion::flare::flare(const ggl::sprite **sprites, int frames, const vec2f& pos, float radius, float radius_factor, int ttl, float depth)
@@ -9,10 +9,12 @@ namespace ggl {
 class sprite;
 };
 
+class particle_system;
+
 class explosion : public effect
 {
 public:
-	explosion(const vec2f& pos, int bang);
+	explosion(particle_system& ps, const vec2f& pos, int bang);
 
 	void draw() const override;
 
@@ -30,7 +32,7 @@ private:
 	static const int NUM_FLARE_FRAMES = 16;
 	const ggl::sprite *flare_sprites_[NUM_FLARE_FRAMES];
 
-	const ggl::sprite *particle_sprite_;
+	int tics_, particles_ttl_;
 
 	class flare
 	{
@@ -50,22 +52,5 @@ private:
 		float depth_;
 	};
 
-	class particle
-	{
-	public:
-		particle(const ggl::sprite *sp, const vec2f& pos);
-
-		bool update();
-		void draw() const;
-
-	private:
-		const ggl::sprite *sp_;
-		vec2f pos_, dir_;
-		int tics_, ttl_;
-		float speed_;
-		rgb color_;
-	};
-
-	std::vector<particle> particles_;
 	std::vector<flare> flares_;
 };
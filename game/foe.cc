@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include <ggl/vec2_util.h>
+#include <ggl/render.h>
 
 #include "game.h"
 #include "foe.h"
@@ -32,7 +33,9 @@ foe::update_position()
 	do {
 		collided = false;
 
-		for (size_t i = 0; i < border.size(); i++) {
+		game_.find_border_edges(pos_, radius_, near_edges_);
+
+		for (auto i : near_edges_) {
 			const vec2f v0 = border[i]*CELL_SIZE;
 			const vec2f v1 = border[(i + 1)%border.size()]*CELL_SIZE;
 
@@ -130,6 +133,13 @@ foe::intersects(const vec2i& center, float radius) const
 	return length(pos_ - vec2f(center)) < radius_ + radius || intersects_children(center, radius);
 }
 
+bool
+foe::get_bounds(ggl::bbox& bounds) const
+{
+	bounds = { pos_ - vec2f { radius_, radius_ }, pos_ + vec2f { radius_, radius_ } };
+	return true;
+}
+
 vec2f
 foe::get_position() const
 {
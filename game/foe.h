@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "entity.h"
 
 class foe : public entity
@@ -9,6 +11,7 @@ public:
 
 	bool intersects(const vec2i& from, const vec2i& to) const override;
 	bool intersects(const vec2i& center, float radius) const override;
+	bool get_bounds(ggl::bbox& bounds) const override;
 
 	void set_direction(const vec2f& dir);
 	vec2f get_direction() const;
@@ -25,6 +28,8 @@ public:
 private:
 	bool collide_against_edge(const vec2f& v0, const vec2f& v1);
 
+	std::vector<size_t> near_edges_;
+
 protected:
 	virtual bool intersects_children(const vec2i& from, const vec2i& to) const = 0;
 	virtual bool intersects_children(const vec2i& center, float radius) const = 0;
@@ -1,4 +1,3 @@
-#include <queue>
 #include <algorithm>
 #include <cassert>
 
@@ -23,12 +22,17 @@
 #include "percent_widget.h"
 #include "lives_widget.h"
 #include "dpad_widget.h"
+#include "debug_widget.h"
 #include "game.h"
 
 namespace {
 
 const int BORDER_RADIUS = 6;
 
+// fill_grid walls: edge between a cell and its left/bottom neighbour
+const uint8_t WALL_LEFT = 1;
+const uint8_t WALL_BOTTOM = 2;
+
 class level_intro_state : public game_state
 {
 public:
@@ -460,12 +464,16 @@ game::game(int width, int height, bool virtual_dpad)
 , player_ { *this }
 , border_texture_ { ggl::res::get_texture("images/border.png") }
 , flash_program_ { ggl::res::get_program("screenflash") }
-, render_target_0_ { viewport_width, viewport_height }
+, flash_va_ { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } }
+, render_target_0_ { viewport_width, viewport_height, true }
 , render_target_1_ { viewport_width, viewport_height }
 , music_player_ { std::move(ggl::g_core->get_audio_player()) }
 {
 	widgets_.emplace_back(new percent_widget(*this));
 	widgets_.emplace_back(new lives_widget(*this));
+#ifndef NDEBUG
+	widgets_.emplace_back(new debug_widget(*this));
+#endif
 
 	using namespace std::placeholders;
 
@@ -506,9 +514,10 @@ game::reset(const level *l)
 	std::fill(std::begin(grid), std::end(grid), 0);
 
 	offset = vec2i { 0, -(grid_rows*CELL_SIZE - viewport_height) };
+	cover_ = 0u;
 	cover_percent_ = 0u;
 
-	update_background();
+	update_background(0, grid_rows);
 
 	// enter_level_intro_state();
 	enter_select_initial_area_state();
@@ -535,19 +544,35 @@ game::get_viewport_offset() const
 void
 game::draw() const
 {
+	const bool outline = ggl::render::get_mesh_outline() == ggl::render::mesh_outline::POST_PROCESS;
+
 	render_target_0_.bind();
+
+	if (outline)
+		render_target_0_.clear_id_buffer();
+
 	draw_scene();
 
-	if (post_filters_.empty()) {
+	// the outline filter goes first, it's the only one that reads the id
+	// buffer and only render_target_0_ has one
+
+	const unsigned num_filters = post_filters_.size() + (outline ? 1 : 0);
+
+	if (num_filters == 0) {
 		passthru_filter_.draw(render_target_0_, ggl::window());
 	} else {
 		const ggl::framebuffer *source = &render_target_0_, *dest = &render_target_1_;
 		ggl::window window;
 
-		const unsigned num_filters = post_filters_.size();
-
 		for (unsigned i = 0; i < num_filters; i++) {
-			post_filters_[i]->draw(*source, i < num_filters - 1 ? *static_cast<const ggl::render_target *>(dest) : window);
+			const post_filter *filter;
+
+			if (outline)
+				filter = i == 0 ? static_cast<const post_filter *>(&outline_filter_) : post_filters_[i - 1].get();
+			else
+				filter = post_filters_[i].get();
+
+			filter->draw(*source, i < num_filters - 1 ? *static_cast<const ggl::render_target *>(dest) : window);
 			std::swap(source, dest);
 		}
 	}
@@ -557,11 +582,9 @@ game::draw() const
 
 		float t = static_cast<float>(flash_tics_)/flash_ttl_;
 
-		static const ggl::vertex_array_flat<GLshort, 2> va { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
-
 		flash_program_->use();
 		flash_program_->set_uniform_f("t", t);
-		va.draw(GL_TRIANGLE_STRIP);
+		flash_va_.draw(GL_TRIANGLE_STRIP);
 	}
 }
 
@@ -590,6 +613,8 @@ game::draw_scene() const
 			e->draw();
 	}
 
+	world_particles_.draw();
+
 	ggl::render::end();
 
 	// relative to screen
@@ -608,63 +633,250 @@ game::draw_scene() const
 			e->draw();
 	}
 
+	screen_particles_.draw();
+
 	ggl::render::end();
 }
 
 void
 game::update_background()
 {
+	// fill routines record cells in increasing index order, so the first and
+	// last entries bound the rows that changed
+
+	if (filled_cells_.empty())
+		return;
+
+	update_background(filled_cells_.front()/grid_cols, filled_cells_.back()/grid_cols + 1);
+}
+
+void
+game::update_background(int first_row, int last_row)
+{
+	if (first_row == 0 && last_row == grid_rows) {
+		// new level, start from scratch
+
+		background_filled_rows_.assign(grid_rows, {});
+		background_unfilled_rows_.assign(grid_rows, {});
+		background_span_verts_ = 0;
+
+		background_filled_rects_.clear();
+		background_unfilled_rects_.clear();
+
+		background_filled_va_.clear();
+		background_filled_va_.upload();
+
+		background_unfilled_va_.clear();
+		background_unfilled_va_.upload();
+	}
+
+	auto find_row_spans = [&](std::vector<background_span>& spans, int i, bool b)
+		{
+			spans.clear();
+
+			auto *row = &grid[i*grid_cols];
+			auto *row_end = row + grid_cols;
+
+			auto *span_start = row;
+
+			while ((span_start = std::find(span_start, row_end, b)) != row_end) {
+				auto *span_end = std::find(span_start, row_end, !b);
+
+				spans.push_back({
+					static_cast<short>(std::distance(row, span_start)),
+					static_cast<short>(std::distance(row, span_end)) });
+
+				span_start = span_end;
+			}
+		};
+
+	// unmerged count: two triangles per span
+
+	for (int i = first_row; i < last_row; i++) {
+		background_span_verts_ -= 6*(background_filled_rows_[i].size() + background_unfilled_rows_[i].size());
+
+		find_row_spans(background_filled_rows_[i], i, true);
+		find_row_spans(background_unfilled_rows_[i], i, false);
+
+		background_span_verts_ += 6*(background_filled_rows_[i].size() + background_unfilled_rows_[i].size());
+	}
+
+	// spans with the same extents in consecutive rows are merged into
+	// rectangles. only rects that overlap or touch the changed rows are
+	// redone; the rest stay where they are in the vertex buffer
+
 	auto& tex = cur_level->fg_texture;
 
 	const float du = static_cast<float>(tex->orig_width)/tex->width/grid_cols;
 	const float dv = static_cast<float>(tex->orig_height)/tex->height/grid_rows;
 
-	auto fill_spans = [&](ggl::vertex_array_texcoord<GLshort, 2, GLfloat, 2>& va, bool b)
+	auto by_start = [](const background_rect& a, const background_rect& b)
 		{
-			va.clear();
+			return a.span.start < b.span.start;
+		};
 
-			float v = 0;
+	std::vector<background_rect> above, below, open, next_open;
+	std::vector<size_t> free_slots;
 
-			short y = 0;
+	auto merge_spans = [&](ggl::vertex_buffer_texcoord<GLshort, 2, GLfloat, 2>& va, std::vector<background_rect>& rects, const std::vector<std::vector<background_span>>& rows)
+		{
+			// take out rects reaching into [first_row - 1, last_row]. their
+			// parts outside the changed rows are kept, and go on merging
+			// with the new spans next to them
 
-			for (int i = 0; i < grid_rows; i++) {
-				auto *row = &grid[i*grid_cols];
-				auto *row_end = row + grid_cols;
+			above.clear();
+			below.clear();
+			free_slots.clear();
 
-				auto *span_start = row;
+			for (size_t i = 0; i < rects.size(); i++) {
+				const auto& rect = rects[i];
 
-				const short yt = y + CELL_SIZE;
+				if (rect.first_row == rect.end_row) {
+					free_slots.push_back(i);
+					continue;
+				}
+
+				if (rect.end_row < first_row || rect.first_row > last_row)
+					continue;
+
+				if (rect.first_row < first_row)
+					above.push_back({ rect.span, rect.first_row, first_row });
+
+				if (rect.end_row > last_row)
+					below.push_back({ rect.span, last_row, rect.end_row });
+
+				free_slots.push_back(i);
+			}
+
+			std::sort(std::begin(above), std::end(above), by_start);
+			std::sort(std::begin(below), std::end(below), by_start);
+
+			size_t next_free_slot = 0;
+
+			size_t first_changed = rects.size();
+			size_t end_changed = 0;
+
+			auto write_rect = [&](size_t slot, const background_rect& rect)
+				{
+					rects[slot] = rect;
+
+					short xs = rect.span.start*CELL_SIZE;
+					short xe = rect.span.end*CELL_SIZE;
+
+					short ys = rect.first_row*CELL_SIZE;
+					short ye = rect.end_row*CELL_SIZE;
+
+					float us = rect.span.start*du;
+					float ue = rect.span.end*du;
+
+					float vs = rect.first_row*dv;
+					float ve = rect.end_row*dv;
+
+					auto *v = &va[6*slot];
+
+					v[0] = { { xs, ys }, { us, vs } };
+					v[1] = { { xe, ys }, { ue, vs } };
+					v[2] = { { xe, ye }, { ue, ve } };
+
+					v[3] = { { xe, ye }, { ue, ve } };
+					v[4] = { { xs, ye }, { us, ve } };
+					v[5] = { { xs, ys }, { us, vs } };
+
+					first_changed = std::min(first_changed, slot);
+					end_changed = std::max(end_changed, slot + 1);
+				};
+
+			auto add_rect = [&](const background_rect& rect)
+				{
+					size_t slot;
+
+					if (next_free_slot < free_slots.size()) {
+						slot = free_slots[next_free_slot++];
+					} else {
+						slot = rects.size();
+						rects.emplace_back();
+						va.resize(va.size() + 6);
+					}
+
+					write_rect(slot, rect);
+				};
 
-				while ((span_start = std::find(span_start, row_end, b)) != row_end) {
-					auto *span_end = std::find(span_start, row_end, !b);
+			auto close_rect = [&](const background_rect& rect, int end_row)
+				{
+					add_rect({ rect.span, rect.first_row, end_row });
+				};
 
-					auto s = std::distance(row, span_start);
-					auto e = std::distance(row, span_end);
+			// open rects are sorted by start column, as are the spans in a row
 
-					short xs = s*CELL_SIZE;
-					short xe = e*CELL_SIZE;
+			open = above;
 
-					auto us = s*du;
-					auto ue = e*du;
+			for (int i = first_row; i < last_row; i++) {
+				next_open.clear();
 
-					va.push_back({ xs, y, us, v });
-					va.push_back({ xe, y, ue, v });
-					va.push_back({ xe, yt, ue, v + dv });
+				auto it = std::begin(open);
 
-					va.push_back({ xe, yt, ue, v + dv });
-					va.push_back({ xs, yt, us, v + dv });
-					va.push_back({ xs, y, us, v });
+				for (auto& span : rows[i]) {
+					while (it != std::end(open) && it->span.start < span.start)
+						close_rect(*it++, i);
 
-					span_start = span_end;
+					if (it != std::end(open) && it->span.start == span.start && it->span.end == span.end)
+						next_open.push_back(*it++);
+					else
+						next_open.push_back({ span, i, i });
 				}
 
-				y += CELL_SIZE;
-				v += dv;
+				while (it != std::end(open))
+					close_rect(*it++, i);
+
+				std::swap(open, next_open);
+			}
+
+			// join what's still open with the parts below the changed rows
+
+			auto it = std::begin(below);
+
+			for (auto& rect : open) {
+				while (it != std::end(below) && it->span.start < rect.span.start)
+					add_rect(*it++);
+
+				if (it != std::end(below) && it->span.start == rect.span.start && it->span.end == rect.span.end)
+					close_rect(rect, (it++)->end_row);
+				else
+					close_rect(rect, last_row);
 			}
+
+			while (it != std::end(below))
+				add_rect(*it++);
+
+			// slots nobody took are left as degenerate triangles
+
+			while (next_free_slot < free_slots.size())
+				write_rect(free_slots[next_free_slot++], { { 0, 0 }, 0, 0 });
+
+			if (first_changed < end_changed)
+				va.upload(6*first_changed, 6*(end_changed - first_changed));
 		};
 
-	fill_spans(background_filled_va_, true);
-	fill_spans(background_unfilled_va_, false);
+	merge_spans(background_filled_va_, background_filled_rects_, background_filled_rows_);
+	merge_spans(background_unfilled_va_, background_unfilled_rects_, background_unfilled_rows_);
+}
+
+size_t
+game::get_background_span_vertex_count() const
+{
+	return background_span_verts_;
+}
+
+size_t
+game::get_background_vertex_count() const
+{
+	auto is_live = [](const background_rect& rect)
+		{
+			return rect.first_row != rect.end_row;
+		};
+
+	return 6*(std::count_if(std::begin(background_filled_rects_), std::end(background_filled_rects_), is_live) +
+	  std::count_if(std::begin(background_unfilled_rects_), std::end(background_unfilled_rects_), is_live));
 }
 
 void
@@ -736,6 +948,15 @@ game::update_border()
 
 	printf("%lu verts\n", border.size());
 
+	//
+	// border edge index
+	//
+
+	border_grid_.reset(grid_cols, grid_rows);
+
+	for (size_t i = 0; i < border.size(); i++)
+		border_grid_.add_edge(i, border[i], border[(i + 1)%border.size()]);
+
 	//
 	// border vertex array
 	//
@@ -767,6 +988,8 @@ game::update_border()
 		border_va_.push_back({ p0.x, p0.y, 0, static_cast<short>(i) });
 		border_va_.push_back({ p1.x, p1.y, 1, static_cast<short>(i) });
 	}
+
+	border_va_.upload();
 }
 
 void
@@ -774,7 +997,6 @@ game::draw_background() const
 {
 	auto prog = ggl::res::get_program("texture");
 	prog->use();
-	prog->set_uniform_mat4("proj_modelview", ggl::render::get_proj_modelview());
 
 	cur_level->fg_texture->bind();
 	background_filled_va_.draw(GL_TRIANGLES);
@@ -794,11 +1016,24 @@ game::update()
 	++tics;
 
 	// entities
-	for (auto it = std::begin(entities); it != std::end(entities); ) {
-		if (!(*it)->update())
-			it = entities.erase(it);
-		else
-			++it;
+	// (by index: updates may add entities. dead ones are swapped with the last)
+	for (size_t i = 0; i < entities.size(); ) {
+		if (!entities[i]->update()) {
+			entities[i] = std::move(entities.back());
+			entities.pop_back();
+		} else {
+			++i;
+		}
+	}
+
+	// entity bounds, for collision checks against the player trail
+	broad_phase_.clear();
+
+	for (auto& e : entities) {
+		ggl::bbox bounds;
+
+		if (e->get_bounds(bounds))
+			broad_phase_.add(e.get(), bounds);
 	}
 
 	// hud
@@ -813,6 +1048,9 @@ game::update()
 			++it;
 	}
 
+	world_particles_.update();
+	screen_particles_.update();
+
 	// post-filters
 	for (auto it = std::begin(post_filters_); it != std::end(post_filters_); ) {
 		if (!(*it)->update())
@@ -837,72 +1075,139 @@ game::fill_grid(const std::vector<vec2i>& contour)
 {
 	// flood fill from boss
 
-	// forbidden transitions
+	// walls between cells, from the contour
 
-	std::vector<std::pair<vec2i, vec2i>> transitions;
+	fill_walls_.resize(grid_rows*grid_cols);
+
+	auto set_wall = [&](const vec2i& cell, uint8_t wall)
+		{
+			if (cell.x >= 0 && cell.x < grid_cols && cell.y >= 0 && cell.y < grid_rows)
+				fill_walls_[cell.y*grid_cols + cell.x] |= wall;
+		};
 
 	for (size_t i = 0; i < contour.size() - 1; i++) {
 		auto& u = contour[i];
 		auto& v = contour[i + 1];
 
-		vec2i p0, p1;
-
 		if (v.y > u.y) {
 			// up
-			transitions.push_back(std::make_pair(u, u + vec2i { -1, 0 }));
+			set_wall(u, WALL_LEFT);
 		} else if (v.y < u.y) {
 			// down
-			transitions.push_back(std::make_pair(u + vec2i { -1, -1 }, u + vec2i { 0, -1 }));
+			set_wall(u + vec2i { 0, -1 }, WALL_LEFT);
 		} else if (v.x < u.x) {
 			// left
-			transitions.push_back(std::make_pair(u + vec2i { -1, 0 }, u + vec2i { -1, -1 }));
+			set_wall(u + vec2i { -1, 0 }, WALL_BOTTOM);
 		} else {
 			// right
-			transitions.push_back(std::make_pair(u, u + vec2i { 0, -1 }));
+			set_wall(u, WALL_BOTTOM);
 		}
 	}
 
+	auto is_open = [&](int c, int r)
+		{
+			return grid[r*grid_cols + c] == 0;
+		};
+
+	auto can_move_left = [&](int c, int r)
+		{
+			return c > 0 && !(fill_walls_[r*grid_cols + c] & WALL_LEFT) && is_open(c - 1, r);
+		};
+
+	auto can_move_right = [&](int c, int r)
+		{
+			return c < grid_cols - 1 && !(fill_walls_[r*grid_cols + c + 1] & WALL_LEFT) && is_open(c + 1, r);
+		};
+
+	auto can_move_down = [&](int c, int r)
+		{
+			return r > 0 && !(fill_walls_[r*grid_cols + c] & WALL_BOTTOM) && is_open(c, r - 1);
+		};
+
+	auto can_move_up = [&](int c, int r)
+		{
+			return r < grid_rows - 1 && !(fill_walls_[(r + 1)*grid_cols + c] & WALL_BOTTOM) && is_open(c, r + 1);
+		};
+
+	// scanline fill
+
 	vec2i pos = (vec2i(cur_boss_->get_position()) + vec2i { CELL_SIZE, CELL_SIZE }/2)/CELL_SIZE;
 
-	std::queue<vec2i> queue;
-	queue.push(pos);
+	std::vector<vec2i> seeds;
+	seeds.push_back(pos);
 
-	grid[pos.y*grid_cols + pos.x] = -1;
+	while (!seeds.empty()) {
+		auto seed = seeds.back();
+		seeds.pop_back();
 
-	while (!queue.empty()) {
-		auto pos = queue.front();
-		queue.pop();
+		int c = seed.x;
+		const int r = seed.y;
 
-		static const vec2i dirs[4] { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+		if (!is_open(c, r))
+			continue;
 
-		for (auto& d : dirs) {
-			auto next_pos = pos + d;
+		while (can_move_left(c, r))
+			--c;
+
+		bool span_below = false, span_above = false;
+
+		for (;;) {
+			grid[r*grid_cols + c] = -1;
+
+			// a wall between two cells of the next row splits it into separate spans
 
-			if (next_pos.x < 0 || next_pos.x >= grid_cols || next_pos.y < 0 || next_pos.y >= grid_rows) {
-				continue;
+			if (can_move_down(c, r)) {
+				if (!span_below || (fill_walls_[(r - 1)*grid_cols + c] & WALL_LEFT)) {
+					seeds.push_back({ c, r - 1 });
+					span_below = true;
+				}
+			} else {
+				span_below = false;
 			}
 
-			if (grid[next_pos.y*grid_cols + next_pos.x]) {
-				continue;
+			if (can_move_up(c, r)) {
+				if (!span_above || (fill_walls_[(r + 1)*grid_cols + c] & WALL_LEFT)) {
+					seeds.push_back({ c, r + 1 });
+					span_above = true;
+				}
+			} else {
+				span_above = false;
 			}
 
-			auto it = std::find_if(
-					std::begin(transitions),
-					std::end(transitions),
-					[=](const std::pair<vec2i, vec2i>& t)
-						{ return (pos == t.first && next_pos == t.second) ||
-							 (pos == t.second && next_pos == t.first); });
+			if (!can_move_right(c, r))
+				break;
 
-			if (it == std::end(transitions)) {
-				grid[next_pos.y*grid_cols + next_pos.x] = -1;
-				queue.push(next_pos);
-			}
+			++c;
+		}
+	}
+
+	// clear walls for next time
+
+	for (size_t i = 0; i < contour.size() - 1; i++) {
+		auto& u = contour[i];
+
+		for (auto& d : { vec2i { 0, 0 }, vec2i { 0, -1 }, vec2i { -1, 0 } }) {
+			auto cell = u + d;
+			if (cell.x >= 0 && cell.x < grid_cols && cell.y >= 0 && cell.y < grid_rows)
+				fill_walls_[cell.y*grid_cols + cell.x] = 0;
 		}
 	}
 
 	// -1 --> 0
 	//  0 --> 1
-	std::transform(std::begin(grid), std::end(grid), std::begin(grid), [](int v) { return std::min(v + 1, 1); });
+
+	filled_cells_.clear();
+
+	for (int i = 0; i < grid_rows*grid_cols; i++) {
+		auto& v = grid[i];
+
+		if (v == -1) {
+			v = 0;
+		} else if (v == 0) {
+			v = 1;
+			filled_cells_.push_back(i);
+		}
+	}
 
 	update_border();
 	update_background();
@@ -912,9 +1217,17 @@ game::fill_grid(const std::vector<vec2i>& contour)
 void
 game::fill_grid(const vec2i& bottom_left, const vec2i& top_right)
 {
+	filled_cells_.clear();
+
 	for (int r = bottom_left.y; r < top_right.y; r++) {
-		auto *row = &grid[r*grid_cols];
-		std::fill(row + bottom_left.x, row + top_right.x, 1);
+		for (int c = bottom_left.x; c < top_right.x; c++) {
+			auto& v = grid[r*grid_cols + c];
+
+			if (!v) {
+				v = 1;
+				filled_cells_.push_back(r*grid_cols + c);
+			}
+		}
 	}
 
 	update_border();
@@ -925,6 +1238,23 @@ game::fill_grid(const vec2i& bottom_left, const vec2i& top_right)
 void
 game::update_cover_percent()
 {
+	// only the cells flipped by the last fill can change the total
+
+	for (auto i : filled_cells_)
+		cover_ += cur_level->silhouette[i];
+
+	assert(cover_ == count_cover());
+
+	cover_percent_ = (static_cast<unsigned long long>(cover_)*10000ull)/cur_level->silhouette_pixels;
+
+	cover_update_event_.notify(cover_percent_);
+}
+
+unsigned
+game::count_cover() const
+{
+	// full rescan, for sanity checks
+
 	unsigned cover = 0;
 
 	for (size_t i = 0; i < grid_rows*grid_cols; i++) {
@@ -933,9 +1263,25 @@ game::update_cover_percent()
 		}
 	}
 
-	cover_percent_ = (static_cast<unsigned long long>(cover)*10000ull)/cur_level->silhouette_pixels;
+	return cover;
+}
 
-	cover_update_event_.notify(cover_percent_);
+void
+game::find_entities(const ggl::bbox& box, std::vector<entity *>& result)
+{
+	broad_phase_.find(box, result);
+}
+
+unsigned
+game::get_skipped_collision_tests() const
+{
+	return broad_phase_.get_skipped_tests();
+}
+
+void
+game::find_border_edges(const vec2f& center, float radius, std::vector<size_t>& edges) const
+{
+	border_grid_.find_edges(center, radius, edges);
 }
 
 unsigned
@@ -974,6 +1320,18 @@ game::add_post_filter(std::unique_ptr<dynamic_post_filter> f)
 	post_filters_.push_back(std::move(f));
 }
 
+particle_system&
+game::get_world_particles()
+{
+	return world_particles_;
+}
+
+particle_system&
+game::get_screen_particles()
+{
+	return screen_particles_;
+}
+
 void
 game::start_screenshake(int duration, float intensity)
 {
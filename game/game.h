@@ -1,8 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
-#include <list>
 #include <functional>
 
 #include <ggl/event.h>
@@ -19,6 +19,9 @@
 #include "player.h"
 #include "post_filter.h"
 #include "level.h"
+#include "border_grid.h"
+#include "broad_phase.h"
+#include "particle_system.h"
 
 namespace ggl {
 class program;
@@ -67,6 +70,9 @@ public:
 	void add_effect(std::unique_ptr<effect> e);
 	void add_post_filter(std::unique_ptr<dynamic_post_filter> f);
 
+	particle_system& get_world_particles();
+	particle_system& get_screen_particles(); // for effects with absolute positions
+
 	void start_screenshake(int duration, float intensity);
 	void start_screenflash(int duration);
 
@@ -94,6 +100,16 @@ public:
 
 	vec2f get_viewport_offset() const;
 
+	// indices into border of edges that may be within radius of center
+	void find_border_edges(const vec2f& center, float radius, std::vector<size_t>& edges) const;
+
+	// entities whose bounds (as of this tick's update) overlap box
+	void find_entities(const ggl::bbox& box, std::vector<entity *>& result);
+	unsigned get_skipped_collision_tests() const;
+
+	size_t get_background_span_vertex_count() const;
+	size_t get_background_vertex_count() const;
+
 	int viewport_width, viewport_height;
 
 	std::vector<int> grid;
@@ -103,7 +119,7 @@ public:
 
 	std::vector<vec2i> border;
 
-	std::list<std::unique_ptr<entity>> entities;
+	std::vector<std::unique_ptr<entity>> entities; // unordered
 
 	vec2i offset;
 
@@ -120,7 +136,9 @@ private:
 
 	void update_border();
 	void update_background();
+	void update_background(int first_row, int last_row);
 	void update_cover_percent();
+	unsigned count_cover() const;
 
 	vec2f find_foe_pos(int radius) const;
 	void add_foes();
@@ -130,6 +148,7 @@ private:
 	unsigned dpad_state_;
 
 	player player_;
+	unsigned cover_; // covered silhouette pixels
 	unsigned cover_percent_;
 
 	int shake_tics_, shake_ttl_;
@@ -138,25 +157,56 @@ private:
 
 	int flash_tics_, flash_ttl_;
 	const ggl::program *flash_program_;
+	ggl::vertex_buffer_flat<GLshort, 2> flash_va_; // full screen quad
 
 	std::vector<std::unique_ptr<widget>> widgets_;
 	std::vector<std::unique_ptr<effect>> effects_;
 	std::vector<std::unique_ptr<dynamic_post_filter>> post_filters_;
 
-	ggl::vertex_array_texcoord<GLshort, 2, GLfloat, 2> background_filled_va_;
-	ggl::vertex_array_texcoord<GLshort, 2, GLfloat, 2> background_unfilled_va_;
-	ggl::vertex_array_texcoord<GLshort, 2, GLshort, 2> border_va_;
+	particle_system world_particles_;
+	particle_system screen_particles_;
+
+	struct background_span
+	{
+		short start, end; // columns
+	};
+
+	struct background_rect
+	{
+		background_span span;
+		int first_row, end_row; // empty if first_row == end_row
+	};
+
+	// per-row spans, so a capture only rescans the rows it touched
+	std::vector<std::vector<background_span>> background_filled_rows_;
+	std::vector<std::vector<background_span>> background_unfilled_rows_;
+	size_t background_span_verts_; // before merging
+
+	// merged rects; slot i owns vertices [6*i, 6*i + 6) in the buffer
+	std::vector<background_rect> background_filled_rects_;
+	std::vector<background_rect> background_unfilled_rects_;
+
+	ggl::vertex_buffer_texcoord<GLshort, 2, GLfloat, 2> background_filled_va_;
+	ggl::vertex_buffer_texcoord<GLshort, 2, GLfloat, 2> background_unfilled_va_;
+	ggl::vertex_buffer_texcoord<GLshort, 2, GLshort, 2> border_va_;
 	const ggl::texture *border_texture_;
 
 	std::unique_ptr<game_state> state_;
 
+	border_grid border_grid_;
+	broad_phase broad_phase_;
+
+	std::vector<uint8_t> fill_walls_;
+	std::vector<int> filled_cells_; // cells flipped by the last fill_grid
+
 	ggl::event<cover_update_event_handler> cover_update_event_;
 	ggl::event<start_event_handler> start_event_;
 	ggl::event<stop_event_handler> stop_event_;
 
-	ggl::framebuffer render_target_0_, render_target_1_;
+	ggl::framebuffer render_target_0_, render_target_1_; // the scene is drawn to 0, which has an id buffer
 
 	passthru_filter passthru_filter_;
+	outline_filter outline_filter_;
 
 	ggl::event_connection_ptr dpad_button_down_conn_;
 	ggl::event_connection_ptr dpad_button_up_conn_;
@@ -7,8 +7,10 @@
 #include <deque>
 
 #include <ggl/gl.h>
+#include <ggl/gl_state.h>
 #include <ggl/app.h>
 #include <ggl/resources.h>
+#include <ggl/mesh.h>
 
 #include "level.h"
 
@@ -33,6 +35,11 @@ game_app::init(int viewport_width, int viewport_height)
 {
 	update_t_ = 0;
 
+	// meshes are small and cheap to read again if the GL context is lost;
+	// level images are big enough that keeping a copy doubles their cost
+	ggl::mesh::set_keep_data(false);
+	ggl::res::set_texture_residency(ggl::res::texture_residency::GL_ONLY);
+
 	ggl::res::load_sprite_sheet("sprites/sprites.spr");
 	ggl::res::load_programs("shaders/effects.xml");
 
@@ -55,7 +62,7 @@ game_app::init_gl_state()
 {
 	glDisable(GL_CULL_FACE);
 	glDisable(GL_DEPTH_TEST);
-	glActiveTexture(GL_TEXTURE0);
+	ggl::gl_state::active_texture(GL_TEXTURE0);
 }
 
 void
@@ -8,7 +8,10 @@ in_game_state::in_game_state(game_app& app)
 : app_state { app }
 , game_ { static_cast<int>(app_.get_scene_width()), static_cast<int>(app_.get_scene_height()), false } // UGH
 {
-	game_.reset(g_levels[0].get());
+	auto l = g_levels[0].get();
+	l->load();
+
+	game_.reset(l);
 }
 
 void
@@ -15,22 +15,47 @@ std::vector<std::unique_ptr<level>> g_levels;
 
 level::level(const std::string& fg_path, const std::string& bg_path, const std::string& mask_path)
 : name { L"test" }
-, fg_texture { ggl::res::get_texture(fg_path) }
-, bg_texture { ggl::res::get_texture(bg_path) }
+, fg_texture { nullptr }
+, bg_texture { nullptr }
+, fg_path_ { fg_path }
+, bg_path_ { bg_path }
+{
+	ggl::res::get_texture_async(fg_path);
+	ggl::res::get_texture_async(bg_path);
+
+	mask_job_ = ggl::loader::enqueue(
+			[this, mask_path] { init_silhouette(mask_path); },
+			[] { });
+}
+
+void
+level::load()
+{
+	ggl::loader::complete(mask_job_);
+
+	fg_texture = ggl::res::get_texture(fg_path_);
+	bg_texture = ggl::res::get_texture(bg_path_);
+
+	assert(fg_texture->orig_width == mask_width_);
+	assert(fg_texture->orig_height == mask_height_);
+
+	assert(bg_texture->orig_width == mask_width_);
+	assert(bg_texture->orig_height == mask_height_);
+}
+
+void
+level::init_silhouette(const std::string& mask_path)
 {
 	ggl::image mask { mask_path };
 
 	assert(mask.width%CELL_SIZE == 0);
 	assert(mask.height%CELL_SIZE == 0);
 
-	assert(fg_texture->orig_width == mask.width);
-	assert(fg_texture->orig_height == mask.height);
-
-	assert(bg_texture->orig_width == mask.width);
-	assert(bg_texture->orig_height == mask.height);
-
 	assert(mask.type == ggl::pixel_type::GRAY);
 
+	mask_width_ = mask.width;
+	mask_height_ = mask.height;
+
 	const unsigned row_stride = mask.row_stride();
 	const uint8_t *mask_pixels = &mask.data[0];
 
@@ -98,15 +123,29 @@ init_levels()
 {
 	auto asset = ggl::g_core->get_asset(LEVELS_XML_PATH);
 
-	std::vector<char> xml(asset->size());
-	asset->read(&xml[0], asset->size());
-
 	TiXmlDocument doc;
-	doc.Parse(&xml[0]);
+	doc.Parse(asset->read_text());
 
 	if (doc.Error())
 		panic("error parsing `%s': %s", LEVELS_XML_PATH, doc.ErrorDesc());
 
+	// assets used in play that we'd rather not load when they first show up
+
+	if (TiXmlElement *preload = doc.RootElement()->FirstChildElement("preload")) {
+		for (TiXmlElement *e = preload->FirstChildElement(); e; e = e->NextSiblingElement()) {
+			const char *value = e->Value();
+			const char *path = e->Attribute("path");
+
+			if (strcmp(value, "texture") == 0) {
+				ggl::res::get_texture_async(path);
+			} else if (strcmp(value, "mesh") == 0) {
+				ggl::res::get_mesh_async(path);
+			} else if (strcmp(value, "page") == 0) {
+				ggl::res::preload_texture_region(path);
+			}
+		}
+	}
+
 	if (TiXmlElement *levels = doc.RootElement()->FirstChildElement("levels")) {
 		for (TiXmlNode *node = levels->FirstChild(); node; node = node->NextSibling())
 			g_levels.push_back(level_from_xml_node(node));
@@ -6,6 +6,8 @@
 
 #include <wchar.h>
 
+#include <ggl/loader.h>
+
 namespace ggl {
 class texture;
 }
@@ -15,15 +17,26 @@ static const int CELL_SIZE = 16;
 class level
 {
 public:
+	// textures and mask are loaded in the background
 	level(const std::string& fg_path, const std::string& bg_path, const std::string& mask_path);
 
+	// waits for anything still loading; before the level is played
+	void load();
+
 	std::basic_string<wchar_t> name;
-	const ggl::texture *fg_texture;
+	const ggl::texture *fg_texture; // nullptr until load()
 	const ggl::texture *bg_texture;
 
 	int grid_rows, grid_cols;
 	std::vector<int> silhouette;
 	unsigned silhouette_pixels;
+
+private:
+	void init_silhouette(const std::string& mask_path); // on the loader thread
+
+	std::string fg_path_, bg_path_;
+	ggl::loader::job_ptr mask_job_;
+	unsigned mask_width_, mask_height_;
 };
 
 extern std::vector<std::unique_ptr<level>> g_levels;
@@ -23,7 +23,6 @@ level_selection_state::draw() const
 
 	auto prog = ggl::res::get_program("flat");
 	prog->use();
-	prog->set_uniform_mat4("proj_modelview", ggl::render::get_proj_modelview());
 	prog->set_uniform_f("color", .5, 1, .5, 1);
 
 	(ggl::vertex_array_flat<GLshort, 2>
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <ggl/noncopyable.h>
+
+// free-list allocator for short-lived entities. freed slots are handed out
+// again, so once the pool has grown to the peak population there are no more
+// heap allocations. chunks are never given back: pools are meant to be static
+// and live as long as the program.
+
+template <typename T, size_t ChunkSize = 64>
+class object_pool : private ggl::noncopyable
+{
+public:
+	void *allocate()
+	{
+		if (!free_list_)
+			grow();
+
+		auto s = free_list_;
+		free_list_ = s->next;
+		return s;
+	}
+
+	void deallocate(void *p)
+	{
+		auto s = static_cast<slot *>(p);
+		s->next = free_list_;
+		free_list_ = s;
+	}
+
+private:
+	union slot
+	{
+		slot *next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+	void grow()
+	{
+		auto chunk = new slot[ChunkSize];
+
+		for (size_t i = 0; i < ChunkSize; i++) {
+			chunk[i].next = free_list_;
+			free_list_ = &chunk[i];
+		}
+	}
+
+	slot *free_list_ = nullptr;
+};
@@ -0,0 +1,185 @@
+#include <cmath>
+#include <cassert>
+
+#include <ggl/sprite.h>
+#include <ggl/rgba.h>
+#include <ggl/render.h>
+
+#include "particle_system.h"
+
+namespace {
+
+const size_t INITIAL_CAPACITY = 1024;
+
+} // (anonymous namespace)
+
+particle_system::particle_system()
+: size_ { 0 }
+, capacity_ { 0 }
+{
+	reserve(INITIAL_CAPACITY);
+}
+
+particle_system::style
+particle_system::get_style(const ggl::sprite *sprite, float x0, float y0, float x1, float y1, float depth)
+{
+	// a handful of styles at most, a linear search is fine
+
+	for (size_t i = 0; i < styles_.size(); i++) {
+		auto& s = styles_[i];
+
+		if (s.sprite == sprite && s.x0 == x0 && s.y0 == y0 && s.x1 == x1 && s.y1 == y1 && s.depth == depth)
+			return i;
+	}
+
+	assert(styles_.size() < 256);
+	styles_.push_back({ sprite, x0, y0, x1, y1, depth });
+
+	return styles_.size() - 1;
+}
+
+void
+particle_system::reserve(size_t capacity)
+{
+	pos_x_.resize(capacity);
+	pos_y_.resize(capacity);
+	speed_x_.resize(capacity);
+	speed_y_.resize(capacity);
+	drag_.resize(capacity);
+	gravity_.resize(capacity);
+	angle_.resize(capacity);
+	angle_speed_.resize(capacity);
+	tics_.resize(capacity);
+	ttl_.resize(capacity);
+	fade_tics_.resize(capacity);
+	color_r_.resize(capacity);
+	color_g_.resize(capacity);
+	color_b_.resize(capacity);
+	style_.resize(capacity);
+
+	capacity_ = capacity;
+}
+
+void
+particle_system::spawn(const particle_desc& p)
+{
+	if (size_ == capacity_)
+		reserve(2*capacity_);
+
+	const size_t i = size_++;
+
+	pos_x_[i] = p.pos.x;
+	pos_y_[i] = p.pos.y;
+	speed_x_[i] = p.speed.x;
+	speed_y_[i] = p.speed.y;
+	drag_[i] = p.drag;
+	gravity_[i] = p.gravity;
+	angle_[i] = p.angle;
+	angle_speed_[i] = p.angle_speed;
+	tics_[i] = 0;
+	ttl_[i] = p.ttl;
+	fade_tics_[i] = p.fade_tics;
+	color_r_[i] = p.color.r;
+	color_g_[i] = p.color.g;
+	color_b_[i] = p.color.b;
+	style_[i] = p.st;
+}
+
+void
+particle_system::move(size_t to, size_t from)
+{
+	pos_x_[to] = pos_x_[from];
+	pos_y_[to] = pos_y_[from];
+	speed_x_[to] = speed_x_[from];
+	speed_y_[to] = speed_y_[from];
+	drag_[to] = drag_[from];
+	gravity_[to] = gravity_[from];
+	angle_[to] = angle_[from];
+	angle_speed_[to] = angle_speed_[from];
+	tics_[to] = tics_[from];
+	ttl_[to] = ttl_[from];
+	fade_tics_[to] = fade_tics_[from];
+	color_r_[to] = color_r_[from];
+	color_g_[to] = color_g_[from];
+	color_b_[to] = color_b_[from];
+	style_[to] = style_[from];
+}
+
+void
+particle_system::update()
+{
+	const size_t n = size_;
+
+	float *__restrict pos_x = &pos_x_[0];
+	float *__restrict pos_y = &pos_y_[0];
+	float *__restrict speed_x = &speed_x_[0];
+	float *__restrict speed_y = &speed_y_[0];
+	const float *__restrict drag = &drag_[0];
+	const float *__restrict gravity = &gravity_[0];
+	float *__restrict angle = &angle_[0];
+	const float *__restrict angle_speed = &angle_speed_[0];
+	int *__restrict tics = &tics_[0];
+
+	// no branches or calls in here, so the compiler can vectorise it
+
+	for (size_t i = 0; i < n; i++) {
+		pos_x[i] += speed_x[i];
+		pos_y[i] += speed_y[i];
+
+		speed_x[i] *= drag[i];
+		speed_y[i] = speed_y[i]*drag[i] + gravity[i];
+
+		angle[i] += angle_speed[i];
+
+		++tics[i];
+	}
+
+	// swap-remove dead particles
+
+	for (size_t i = 0; i < size_; ) {
+		if (tics_[i] >= ttl_[i])
+			move(i, --size_);
+		else
+			++i;
+	}
+}
+
+void
+particle_system::draw() const
+{
+	for (size_t i = 0; i < size_; i++) {
+		const auto& s = styles_[style_[i]];
+
+		const int tics = tics_[i];
+		const int ttl = ttl_[i];
+		const int fade_tics = fade_tics_[i];
+
+		const float alpha = tics < fade_tics ? 1.f : 1.f - static_cast<float>(tics - fade_tics)/(ttl - fade_tics);
+
+		// particle space to world: rotate by angle, then translate by pos
+
+		const float c = cosf(angle_[i]);
+		const float sn = sinf(angle_[i]);
+
+		const vec2f pos { pos_x_[i], pos_y_[i] };
+
+		auto transform = [&](float x, float y) { return pos + vec2f { c*x - sn*y, sn*x + c*y }; };
+
+		const ggl::quad q {
+			transform(s.x0, s.y0),
+			transform(s.x0, s.y1),
+			transform(s.x1, s.y1),
+			transform(s.x1, s.y0) };
+
+		const auto sp = s.sprite;
+
+		ggl::render::set_color({ color_r_[i], color_g_[i], color_b_[i], alpha });
+		ggl::render::draw(sp->tex, { { sp->u0, sp->v1 }, { sp->u1, sp->v0 } }, q, s.depth);
+	}
+}
+
+void
+particle_system::clear()
+{
+	size_ = 0;
+}
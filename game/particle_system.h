@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <ggl/noncopyable.h>
+#include <ggl/vec2.h>
+
+#include "rgb.h"
+
+namespace ggl {
+class sprite;
+}
+
+// structure-of-arrays particle engine. emitters spawn particles into it and
+// the whole population is updated in one loop and drawn as quads straight
+// into the renderer queue, without going through the matrix stack.
+
+class particle_system : private ggl::noncopyable
+{
+public:
+	particle_system();
+
+	// how particles look: a sprite stretched over the box (x0, y0)-(x1, y1) in
+	// particle space, where +x is the particle's angle
+	using style = uint8_t;
+	style get_style(const ggl::sprite *sprite, float x0, float y0, float x1, float y1, float depth);
+
+	struct particle_desc
+	{
+		vec2f pos, speed;
+		float drag; // speed multiplier per tic
+		float gravity; // added to speed.y per tic
+		float angle, angle_speed;
+		int ttl;
+		int fade_tics; // fully opaque until here, then fades out linearly to ttl
+		rgb color;
+		style st;
+	};
+
+	void spawn(const particle_desc& p);
+
+	void update();
+	void draw() const;
+
+	void clear();
+
+	size_t size() const
+	{ return size_; }
+
+private:
+	void reserve(size_t capacity);
+	void move(size_t to, size_t from);
+
+	struct style_info
+	{
+		const ggl::sprite *sprite;
+		float x0, y0, x1, y1;
+		float depth;
+	};
+	std::vector<style_info> styles_;
+
+	size_t size_, capacity_;
+
+	std::vector<float> pos_x_, pos_y_;
+	std::vector<float> speed_x_, speed_y_;
+	std::vector<float> drag_, gravity_;
+	std::vector<float> angle_, angle_speed_;
+	std::vector<int> tics_, ttl_, fade_tics_;
+	std::vector<float> color_r_, color_g_, color_b_;
+	std::vector<style> style_;
+};
@@ -1,78 +1,48 @@
+#include <algorithm>
+
 #include <ggl/resources.h>
 #include <ggl/sprite.h>
-#include <ggl/render.h>
 
 #include "bezier.h"
 #include "util.h"
+#include "particle_system.h"
 #include "particles.h"
 
-particles::particles(const vec2f& pos, int num_particles, const gradient& g)
-{
-	particles_.reserve(num_particles);
-
-	for (size_t i = 0; i < num_particles; i++)
-		particles_.emplace_back(pos, g);
-}
-
-void
-particles::draw() const
-{
-	for (auto& p : particles_)
-		p.draw();
-}
-
-bool
-particles::do_update()
+particles::particles(particle_system& ps, const vec2f& pos, int num_particles, const gradient& g)
+: tics_ { 0 }
+, ttl_ { 0 }
 {
-	bool rv = false;
+	auto sprite = ggl::res::get_sprite("star.png");
 
-	for (auto& p : particles_) {
-		if (p.update())
-			rv = true;
-	}
+	const float w = .5f*sprite->width;
+	const float h = .5f*sprite->height;
 
-	return rv;
-}
+	const auto st = ps.get_style(sprite, -w, -h, w, h, 0);
 
-particles::particle::particle(const vec2f& origin, const gradient& g)
-: sprite_ { ggl::res::get_sprite("star.png") }
-, pos_ { origin }
-, speed_ { [&] { const float a = rand<float>(0, 2.f*M_PI); return .7f*rand<float>(3., 5.)*vec2f(cosf(a), sinf(a)); }() }
-, angle_ { rand<float>(0, 2.f*M_PI) }
-, angle_speed_ { rand<float>(-.15, .15) }
-, tics_ { 0 }
-, ttl_ { rand<int>(20, 50) }
-, color_ { g(rand<float>(0, 1)) }
-{ }
-
-void
-particles::particle::draw() const
-{
-	if (tics_ >= ttl_)
-		return;
+	for (size_t i = 0; i < num_particles; i++) {
+		const float a = rand<float>(0, 2.f*M_PI);
+		const int ttl = rand<int>(20, 50);
 
-	const int ft = .8f*ttl_;
-	const float a = tics_ < ft ? 1.f : 1.f - static_cast<float>(tics_ - ft)/(ttl_ - ft);
+		particle_system::particle_desc p;
+		p.pos = pos;
+		p.speed = .7f*rand<float>(3., 5.)*vec2f(cosf(a), sinf(a));
+		p.drag = 1;
+		p.gravity = -.15f;
+		p.angle = rand<float>(0, 2.f*M_PI);
+		p.angle_speed = rand<float>(-.15, .15);
+		p.ttl = ttl;
+		p.fade_tics = .8f*ttl;
+		p.color = g(rand<float>(0, 1));
+		p.st = st;
 
-	ggl::render::set_color({ color_.r, color_.g, color_.b, a });
+		ps.spawn(p);
 
-	ggl::render::push_matrix();
-	ggl::render::translate(pos_);
-	ggl::render::rotate(angle_);
-	sprite_->draw(0);
-	ggl::render::pop_matrix();
+		ttl_ = std::max(ttl_, ttl);
+	}
 }
 
 bool
-particles::particle::update()
+particles::do_update()
 {
-	if (tics_ >= ttl_)
-		return false;
-
-	++tics_;
-	pos_ += speed_;
-	speed_ += vec2f(0, -.15f);
-	angle_ += angle_speed_;
-
-	return true;
+	return tics_++ < ttl_;
 }
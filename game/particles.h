@@ -7,18 +7,20 @@
 #include "bezier.h"
 #include "effect.h"
 
-namespace ggl {
-class sprite;
-};
+class particle_system;
 
 using gradient = bezier<rgb>;
 
+// burst of spinning stars. the particles themselves live in (and are drawn by)
+// a particle_system, this only tracks when they're all gone.
+
 class particles : public effect
 {
 public:
-	particles(const vec2f& pos, int num_particles, const gradient& g);
+	particles(particle_system& ps, const vec2f& pos, int num_particles, const gradient& g);
 
-	void draw() const override;
+	void draw() const override
+	{ }
 
 	bool is_position_absolute() const override
 	{ return true; }
@@ -26,21 +28,5 @@ public:
 private:
 	bool do_update() override;
 
-	class particle {
-	public:
-		particle(const vec2f& origin, const gradient& g);
-
-		void draw() const;
-		bool update();
-
-	private:
-		const ggl::sprite *sprite_;
-		vec2f pos_, speed_;
-		float angle_, angle_speed_;
-		int tics_, ttl_;
-		rgb color_;
-	};
-
-	std::vector<particle> particles_;
-	ggl::sprite *sprite_;
+	int tics_, ttl_;
 };
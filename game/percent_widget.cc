@@ -234,7 +234,7 @@ percent_widget::on_cover_update(unsigned percent)
 		game_.add_effect(std::move(e));
 
 		const gradient particle_colors { { 1.f, .5f, 0.f }, { 1.f, 1.f, 0.f }, { 1.f, 1.f, 1.f } };
-		game_.add_effect(std::unique_ptr<effect> { new particles { pos, 20, particle_colors } });
+		game_.add_effect(std::unique_ptr<effect> { new particles { game_.get_screen_particles(), pos, 20, particle_colors } });
 	}
 }
 
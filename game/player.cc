@@ -48,6 +48,7 @@ const int EXPLODE_SEGMENT_TICS = 2;
 
 player::player(game& g)
 : game_ { g }
+, trail_va_ { GL_DYNAMIC_DRAW }
 , trail_texture_ { ggl::res::get_texture("images/trail.png") }
 {
 	for (int i = 0; i < NUM_FRAMES; i++) {
@@ -65,9 +66,43 @@ void
 player::reset(const vec2i& pos)
 {
 	lives_left_ = 2;
+
+	extend_trail_.clear();
+	trail_cells_.assign((game_.grid_cols + 1)*(game_.grid_rows + 1), 0);
+
 	respawn(pos);
 }
 
+bool
+player::is_on_trail(const vec2i& p) const
+{
+	return trail_cells_[p.y*(game_.grid_cols + 1) + p.x];
+}
+
+void
+player::push_trail(const vec2i& p)
+{
+	extend_trail_.push_back(p);
+	trail_cells_[p.y*(game_.grid_cols + 1) + p.x] = 1;
+}
+
+void
+player::pop_trail()
+{
+	auto& p = extend_trail_.back();
+	trail_cells_[p.y*(game_.grid_cols + 1) + p.x] = 0;
+	extend_trail_.pop_back();
+}
+
+void
+player::clear_trail()
+{
+	for (auto& p : extend_trail_)
+		trail_cells_[p.y*(game_.grid_cols + 1) + p.x] = 0;
+
+	extend_trail_.clear();
+}
+
 void
 player::respawn(const vec2i& pos)
 {
@@ -87,13 +122,13 @@ player::move_extend(direction dir)
 
 	auto extend_to = [&](const vec2i& where)
 		{
-			auto it = std::find(std::begin(extend_trail_), std::end(extend_trail_), where);
+			// can't cross the trail, but can back up along it
 
-			if (it == extend_trail_.end() || it + 1 == extend_trail_.end()) {
+			if (!is_on_trail(where) || extend_trail_.back() == where) {
 				next_pos_ = where;
 
 				if (extend_trail_.empty() || extend_trail_.back() != where)
-					extend_trail_.push_back(pos_);
+					push_trail(pos_);
 
 				set_state(state::EXTENDING);
 			}
@@ -247,7 +282,7 @@ player::update_extending(unsigned dpad_state)
 		pos_ = next_pos_;
 
 		if (!extend_trail_.empty() && extend_trail_.back() == pos_)
-			extend_trail_.pop_back();
+			pop_trail();
 
 		if (extend_trail_.empty()) {
 			set_state(state::IDLE);
@@ -261,11 +296,11 @@ player::update_extending(unsigned dpad_state)
 		if (p[0] || p[-1] || p[-grid_cols] || p[-grid_cols - 1]) {
 			// filled region
 
-			extend_trail_.push_back(pos_);
+			push_trail(pos_);
 
 			game_.fill_grid(extend_trail_);
 
-			extend_trail_.clear();
+			clear_trail();
 			set_state(state::IDLE);
 			return;
 		}
@@ -288,7 +323,7 @@ player::update_exploding(unsigned dpad_state)
 			if (index%2 == 0) {
 				vec2f v0 = extend_trail_[extend_trail_.size() - index]*CELL_SIZE;
 				vec2f v1 = extend_trail_[extend_trail_.size() - index - 1]*CELL_SIZE;
-				game_.add_effect(std::unique_ptr<effect>(new explosion(.5f*(v0 + v1), 0)));
+				game_.add_effect(std::unique_ptr<effect>(new explosion(game_.get_world_particles(), .5f*(v0 + v1), 0)));
 			}
 		}
 	}
@@ -302,7 +337,7 @@ player::update_death(unsigned dpad_state)
 			--lives_left_;
 
 			auto p = extend_trail_.front();
-			extend_trail_.clear();
+			clear_trail();
 			respawn(p);
 		} else {
 			set_state(state::DEAD);
@@ -314,31 +349,47 @@ void
 player::check_foe_collisions()
 {
 	if (extend_trail_.size() > 1) {
-		auto& entities = game_.entities;
+		// only entities whose bounds overlap a piece of the trail get the narrow-phase test
+
+		auto find_near_entities = [this](const vec2i& from, const vec2i& to, float radius)
+			{
+				const ggl::bbox box {
+					{ std::min(from.x, to.x) - radius, std::min(from.y, to.y) - radius },
+					{ std::max(from.x, to.x) + radius, std::max(from.y, to.y) + radius } };
+
+				game_.find_entities(box, near_entities_);
+			};
+
+		auto segment_hit = [&](const vec2i& v0, const vec2i& v1)
+			{
+				find_near_entities(v0, v1, 0);
+
+				return std::any_of(
+						std::begin(near_entities_),
+						std::end(near_entities_),
+						[&](const entity *e) { return e->intersects(v0, v1); });
+			};
 
-		auto it = std::find_if(
-				std::begin(entities),
-				std::end(entities),
-				[this](std::unique_ptr<entity>& f)
-					{
-						for (size_t i = 0; i < extend_trail_.size() - 1; i++) {
-							const vec2i v0 = extend_trail_[i]*CELL_SIZE;
-							const vec2i v1 = extend_trail_[i + 1]*CELL_SIZE;
+		bool collided = false;
 
-							if (f->intersects(v0, v1))
-								return true;
-						}
+		for (size_t i = 0; !collided && i < extend_trail_.size() - 1; i++)
+			collided = segment_hit(extend_trail_[i]*CELL_SIZE, extend_trail_[i + 1]*CELL_SIZE);
 
-						if (f->intersects(extend_trail_.back()*CELL_SIZE, get_position()))
-							return true;
+		if (!collided)
+			collided = segment_hit(extend_trail_.back()*CELL_SIZE, get_position());
 
-						if (f->intersects(get_position(), PLAYER_RADIUS))
-							return true;
+		if (!collided) {
+			const vec2i p = get_position();
 
-						return false;
-					});
+			find_near_entities(p, p, PLAYER_RADIUS);
 
-		if (it != std::end(entities))
+			collided = std::any_of(
+					std::begin(near_entities_),
+					std::end(near_entities_),
+					[&](const entity *e) { return e->intersects(p, PLAYER_RADIUS); });
+		}
+
+		if (collided)
 			die();
 	}
 }
@@ -364,7 +415,7 @@ player::die()
 		a += da;
 	}
 
-	game_.add_effect(std::unique_ptr<effect>(new explosion(get_position(), 1)));
+	game_.add_effect(std::unique_ptr<effect>(new explosion(game_.get_world_particles(), get_position(), 1)));
 	game_.start_screenshake(60, 40.f);
 	game_.add_post_filter(std::unique_ptr<dynamic_post_filter>(new ripple_filter(60., get_position() + game_.offset, 3.f, 200.f)));
 	game_.start_screenflash(20);
@@ -404,13 +455,31 @@ player::draw() const
 void
 player::draw_trail(int size) const
 {
-	static const int TRAIL_RADIUS = 6;
-
 	assert(size <= extend_trail_.size());
 
 	if (size < 2)
 		return;
 
+	// only rebuild (and re-upload) the strip if the trail changed since the last frame
+
+	if (size != trail_va_points_.size() ||
+	    !std::equal(std::begin(trail_va_points_), std::end(trail_va_points_), std::begin(extend_trail_)))
+		update_trail_va(size);
+
+	auto prog = ggl::res::get_program("texture");
+	prog->use();
+
+	trail_texture_->bind();
+
+	ggl::enable_alpha_blend _;
+	trail_va_.draw(GL_TRIANGLE_STRIP);
+}
+
+void
+player::update_trail_va(int size) const
+{
+	static const int TRAIL_RADIUS = 6;
+
 	GLshort u = 0;
 
 	trail_va_.clear();
@@ -471,14 +540,9 @@ player::draw_trail(int size) const
 		++u;
 	}
 
-	auto prog = ggl::res::get_program("texture");
-	prog->use();
-	prog->set_uniform_mat4("proj_modelview", ggl::render::get_proj_modelview());
-
-	trail_texture_->bind();
+	trail_va_.upload();
 
-	ggl::enable_alpha_blend _;
-	trail_va_.draw(GL_TRIANGLE_STRIP);
+	trail_va_points_.assign(std::begin(extend_trail_), std::begin(extend_trail_) + size);
 }
 
 void
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include <ggl/event.h>
@@ -7,6 +8,7 @@
 #include <ggl/vec2.h>
 
 class game;
+class entity;
 
 namespace ggl {
 class sprite;
@@ -26,6 +28,9 @@ public:
 	vec2i get_grid_position() const;
 	void set_grid_position(const vec2i& p);
 
+	// is grid vertex p on the trail being extended?
+	bool is_on_trail(const vec2i& p) const;
+
 	enum class direction { UP, DOWN, LEFT, RIGHT, NONE };
 
 	using respawn_event_handler = std::function<void(int)>;
@@ -37,7 +42,13 @@ public:
 private:
 	void respawn(const vec2i& pos);
 
+	// extend_trail_ and trail_cells_ are only changed through these
+	void push_trail(const vec2i& p);
+	void pop_trail();
+	void clear_trail();
+
 	void draw_trail(int size) const;
+	void update_trail_va(int size) const;
 	void draw_head() const;
 
 	void move_slide(direction dir);
@@ -58,6 +69,8 @@ private:
 	game& game_;
 	vec2i pos_, next_pos_;
 	std::vector<vec2i> extend_trail_;
+	std::vector<uint8_t> trail_cells_; // (grid_cols + 1)*(grid_rows + 1) vertices, 1 if on extend_trail_
+	std::vector<entity *> near_entities_; // scratch, for check_foe_collisions
 	state state_;
 	int state_tics_;
 	int lives_left_;
@@ -66,7 +79,8 @@ private:
 	const ggl::sprite *sprites_core_[NUM_FRAMES];
 	const ggl::sprite *sprites_shield_[NUM_FRAMES];
 
-	mutable ggl::vertex_array_texcoord<GLshort, 2, GLshort, 2> trail_va_;
+	mutable ggl::vertex_buffer_texcoord<GLshort, 2, GLshort, 2> trail_va_;
+	mutable std::vector<vec2i> trail_va_points_; // trail_va_ was built from these
 	const ggl::texture *trail_texture_;
 
 	ggl::event<respawn_event_handler> respawn_event_;
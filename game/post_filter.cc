@@ -3,6 +3,7 @@
 #include <ggl/framebuffer.h>
 #include <ggl/vertex_array.h>
 #include <ggl/program.h>
+#include <ggl/gl_state.h>
 
 #include "post_filter.h"
 
@@ -30,12 +31,45 @@ passthru_filter::draw(const ggl::framebuffer& source, const ggl::render_target&
 	fullscreen_va.draw(GL_TRIANGLE_STRIP);
 }
 
+outline_filter::outline_filter()
+: post_filter { "outline-filter" }
+, resolution_uniform_ ( program_->get_uniform("resolution") )
+{
+	program_->use();
+	program_->set_uniform_i("source_buffer", 0);
+	program_->set_uniform_i("id_buffer", 1);
+	program_->set_uniform_f("width", 1.5); // about as thick as the geometry outline
+	program_->set_uniform_f("color", 0, 0, 0, 1);
+}
+
+void
+outline_filter::draw(const ggl::framebuffer& source, const ggl::render_target& dest) const
+{
+	program_->use();
+	program_->set_uniform_f(resolution_uniform_, source.get_width(), source.get_height());
+
+	dest.bind();
+
+	ggl::gl_state::active_texture(GL_TEXTURE1);
+	source.bind_id_texture();
+
+	ggl::gl_state::active_texture(GL_TEXTURE0);
+	source.bind_texture();
+
+	fullscreen_va.draw(GL_TRIANGLE_STRIP);
+}
+
 dynamic_post_filter::dynamic_post_filter(const char *program)
 : post_filter { program }
 { }
 
 ripple_filter::ripple_filter(float width, const vec2f& center, float speed, int ttl)
 : dynamic_post_filter { "ripple-filter" }
+, resolution_uniform_ ( program_->get_uniform("resolution") )
+, width_uniform_ ( program_->get_uniform("width") )
+, center_uniform_ ( program_->get_uniform("center") )
+, radius_uniform_ ( program_->get_uniform("radius") )
+, scale_uniform_ ( program_->get_uniform("scale") )
 , width_ { width }
 , center_ { center }
 , radius_ { 0 }
@@ -58,11 +92,11 @@ void
 ripple_filter::draw(const ggl::framebuffer& source, const ggl::render_target& dest) const
 {
 	program_->use();
-	program_->set_uniform_f("resolution", source.get_width(), source.get_height());
-	program_->set_uniform_f("width", width_);
-	program_->set_uniform_f("center", center_.x, center_.y);
-	program_->set_uniform_f("radius", radius_);
-	program_->set_uniform_f("scale", .02f*(1.f - static_cast<float>(tics_)/ttl_));
+	program_->set_uniform_f(resolution_uniform_, source.get_width(), source.get_height());
+	program_->set_uniform_f(width_uniform_, width_);
+	program_->set_uniform_f(center_uniform_, center_.x, center_.y);
+	program_->set_uniform_f(radius_uniform_, radius_);
+	program_->set_uniform_f(scale_uniform_, .02f*(1.f - static_cast<float>(tics_)/ttl_));
 
 	dest.bind();
 	source.bind_texture();
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <ggl/program.h>
+
 namespace ggl {
 class framebuffer;
 class render_target;
-class program;
 }
 
 class post_filter
@@ -26,6 +27,19 @@ public:
 	void draw(const ggl::framebuffer& source, const ggl::render_target& dest) const override;
 };
 
+// outlines meshes by edge-detecting the source's id buffer; used with
+// ggl::render::mesh_outline::POST_PROCESS
+class outline_filter : public post_filter
+{
+public:
+	outline_filter();
+
+	void draw(const ggl::framebuffer& source, const ggl::render_target& dest) const override;
+
+private:
+	ggl::program::uniform resolution_uniform_;
+};
+
 class dynamic_post_filter : public post_filter
 {
 public:
@@ -43,6 +57,12 @@ public:
 	bool update() override;
 
 private:
+	ggl::program::uniform resolution_uniform_;
+	ggl::program::uniform width_uniform_;
+	ggl::program::uniform center_uniform_;
+	ggl::program::uniform radius_uniform_;
+	ggl::program::uniform scale_uniform_;
+
 	float width_;
 	vec2f center_;
 	float radius_;
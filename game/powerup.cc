@@ -11,6 +11,7 @@
 
 #include "game.h"
 #include "effect.h"
+#include "object_pool.h"
 #include "powerup.h"
 
 namespace {
@@ -67,8 +68,23 @@ picked_effect::draw() const
 	font_->draw(0, text_, { pos_.x, pos_.y + delta_y_ });
 }
 
+object_pool<powerup> powerup_pool;
+
 };
 
+void *
+powerup::operator new(size_t size)
+{
+	assert(size == sizeof(powerup));
+	return powerup_pool.allocate();
+}
+
+void
+powerup::operator delete(void *p)
+{
+	powerup_pool.deallocate(p);
+}
+
 powerup::powerup(game& g, const vec2f& pos, const vec2f& dir)
 : entity { g }
 , pos_ { pos }
@@ -7,11 +7,14 @@ namespace ggl {
 class sprite;
 }
 
-class powerup : public entity
+class powerup final : public entity
 {
 public:
 	powerup(game& g, const vec2f& pos, const vec2f& dir);
 
+	static void *operator new(size_t size);
+	static void operator delete(void *p);
+
 	void draw() const override;
 	bool update() override;
 
@@ -21,6 +24,9 @@ public:
 	bool intersects(const vec2i&, float) const override
 	{ return false; }
 
+	bool get_bounds(ggl::bbox&) const override
+	{ return false; }
+
 private:
 	bool update_moving();
 	bool update_sliding();
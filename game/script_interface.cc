@@ -279,10 +279,7 @@ script_interface::create_script_thread(const std::string& path)
 
 		auto asset = ggl::g_core->get_asset(path.c_str());
 
-		std::vector<char> script(asset->size());
-		asset->read(&script[0], asset->size());
-
-		if (luaL_loadbuffer(lua_state_, &script[0], asset->size(),path.c_str())) {
+		if (luaL_loadbuffer(lua_state_, asset->read_text(), asset->size(), path.c_str())) {
 			fprintf(stderr, "failed to parse %s: %s\n", path.c_str(), lua_tostring(lua_state_, -1));
 			lua_pop(lua_state_, 1);
 			return nullptr;
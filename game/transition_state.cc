@@ -1,5 +1,6 @@
 #include <ggl/resources.h>
 #include <ggl/program.h>
+#include <ggl/gl_state.h>
 #include <ggl/window.h>
 #include <ggl/vertex_array.h>
 
@@ -38,13 +39,13 @@ transition_state::draw() const
 
 	ggl::window().bind();
 
-	gl_check(glActiveTexture(GL_TEXTURE0));
+	ggl::gl_state::active_texture(GL_TEXTURE0);
 	fb_from_.bind_texture();
 
-	gl_check(glActiveTexture(GL_TEXTURE1));
+	ggl::gl_state::active_texture(GL_TEXTURE1);
 	fb_to_.bind_texture();
 
-	gl_check(glActiveTexture(GL_TEXTURE0));
+	ggl::gl_state::active_texture(GL_TEXTURE0);
 
 	program_->use();
 
@@ -54,7 +55,7 @@ transition_state::draw() const
 	program_->set_uniform_f("level", static_cast<float>(tics_)/TRANSITION_TICS);
 	program_->set_uniform_f("resolution", fb_from_.get_width(), fb_from_.get_height());
 
-	glDisable(GL_BLEND);
+	ggl::gl_state::disable_blend();
 
 	(ggl::vertex_array_texcoord<GLshort, 2, GLshort, 2>
 	  { { { -1, -1, 0, 0 },
@@ -309,10 +309,10 @@ parse_action(TiXmlNode *node)
 action_ptr
 load_action(const std::string& path)
 {
-	auto xml = g_core->get_asset(path)->read_all();
+	auto asset = g_core->get_asset(path);
 
 	TiXmlDocument doc;
-	doc.Parse(&xml[0]);
+	doc.Parse(asset->read_text());
 
 	return parse_action(doc.RootElement()->FirstChild());
 }
@@ -2,6 +2,9 @@
 
 #include <ggl/log.h>
 #include <ggl/gl.h>
+#include <ggl/gl_state.h>
+#include <ggl/render.h>
+#include <ggl/loader.h>
 #include <ggl/resources.h>
 #include <ggl/android/asset.h>
 #include <ggl/android/core.h>
@@ -23,6 +26,7 @@ core::core(app& a, android_app *state)
 
 core::~core()
 {
+	loader::shutdown();
 	term_display();
 }
 
@@ -158,7 +162,7 @@ core::handle_input(AInputEvent *event)
 			if (AKeyEvent_getAction(event) == AKEY_EVENT_ACTION_DOWN) {
 				switch (AKeyEvent_getKeyCode(event)) {
 					case AKEYCODE_MENU:
-						// XXX something here
+						render::toggle_mesh_outline();
 						return 1;
 
 					case AKEYCODE_BACK:
@@ -253,10 +257,13 @@ core::run()
 			float t = now();
 			if (last_update == 0)
 				last_update = t;
+			loader::poll();
 			app_.update_and_render(t - last_update);
 			last_update = t;
 
 			eglSwapBuffers(display_, surface_);
+			gl_state::end_frame();
+			render::end_frame();
 		}
 	}
 
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+
 #include <ggl/asset.h>
 
 namespace {
@@ -29,6 +32,18 @@ asset::read_all()
 	return data;
 }
 
+const char *
+asset::read_text()
+{
+	if (auto p = data())
+		return p;
+
+	text_ = read_all();
+	text_.push_back('\0');
+
+	return &text_[0];
+}
+
 uint8_t
 asset::read_uint8()
 {
@@ -40,17 +55,17 @@ asset::read_uint8()
 uint16_t
 asset::read_uint16()
 {
-	uint8_t lo = read_uint8();
-	uint8_t hi = read_uint8();
-	return lo | (hi << 8);
+	uint8_t b[2];
+	read(b, sizeof b);
+	return b[0] | (b[1] << 8);
 }
 
 uint32_t
 asset::read_uint32()
 {
-	uint16_t lo = read_uint16();
-	uint16_t hi = read_uint16();
-	return lo | (hi << 16);
+	uint8_t b[4];
+	read(b, sizeof b);
+	return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
 }
 
 float
@@ -60,4 +75,26 @@ asset::read_float()
 	return ieee_to_float(v);
 }
 
+buffer_asset::buffer_asset(std::vector<char> data)
+: data_ { std::move(data) }
+, pos_ { 0 }
+{
+	data_.push_back('\0');
+}
+
+off_t
+buffer_asset::size() const
+{
+	return data_.size() - 1;
+}
+
+size_t
+buffer_asset::read(void *buf, size_t size)
+{
+	size = std::min(size, data_.size() - 1 - pos_);
+	std::memcpy(buf, &data_[pos_], size);
+	pos_ += size;
+	return size;
+}
+
 }
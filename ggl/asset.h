@@ -18,12 +18,42 @@ public:
 	virtual off_t size() const = 0;
 	virtual size_t read(void *buf, size_t size) = 0;
 
+	// the whole contents, NUL-terminated, if they're already in memory
+	// (see bundle); nullptr otherwise
+	virtual const char *data() const
+	{ return nullptr; }
+
 	std::vector<char> read_all();
 
+	// the whole contents, NUL-terminated. doesn't copy if data() is
+	// available, otherwise reads into a buffer owned by the asset
+	const char *read_text();
+
 	uint8_t read_uint8();
 	uint16_t read_uint16();
 	uint32_t read_uint32();
 	float read_float();
+
+private:
+	std::vector<char> text_;
+};
+
+// an asset that's been read into memory, e.g. by a background job
+
+class buffer_asset : public asset
+{
+public:
+	buffer_asset(std::vector<char> data);
+
+	off_t size() const override;
+	size_t read(void *buf, size_t size) override;
+
+	const char *data() const override
+	{ return &data_[0]; }
+
+private:
+	std::vector<char> data_; // plus a NUL
+	size_t pos_;
 };
 
 }
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstring>
+
+#include <ggl/panic.h>
+#include <ggl/asset.h>
+#include <ggl/asset_reader.h>
+
+namespace ggl {
+
+namespace {
+
+const size_t BUFFER_SIZE = 4096;
+
+// assets are little-endian; on big-endian hosts arrays are swapped in
+// place after the copy. the loops are simple enough to be vectorised
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+void
+from_little_endian(uint16_t *p, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		p[i] = __builtin_bswap16(p[i]);
+}
+
+void
+from_little_endian(uint32_t *p, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		p[i] = __builtin_bswap32(p[i]);
+}
+#else
+void
+from_little_endian(uint16_t *, size_t)
+{ }
+
+void
+from_little_endian(uint32_t *, size_t)
+{ }
+#endif
+
+static_assert(sizeof(float) == sizeof(uint32_t), "floats aren't 32 bits");
+
+} // (anonymous namespace)
+
+asset_reader::asset_reader(asset& a)
+: asset_ { a }
+{
+	if (auto p = a.data()) {
+		pos_ = p;
+		end_ = p + a.size();
+	} else {
+		buffer_.resize(BUFFER_SIZE);
+		pos_ = end_ = &buffer_[0];
+	}
+}
+
+void
+asset_reader::fill()
+{
+	if (buffer_.empty())
+		panic("unexpected end of asset");
+
+	size_t size = asset_.read(&buffer_[0], buffer_.size());
+	if (size == 0)
+		panic("unexpected end of asset");
+
+	pos_ = &buffer_[0];
+	end_ = pos_ + size;
+}
+
+void
+asset_reader::read(void *dest, size_t size)
+{
+	auto p = static_cast<char *>(dest);
+
+	while (size > 0) {
+		if (pos_ == end_) {
+			// large reads skip the buffer
+			if (size >= BUFFER_SIZE && !buffer_.empty()) {
+				if (asset_.read(p, size) != size)
+					panic("unexpected end of asset");
+				return;
+			}
+
+			fill();
+		}
+
+		size_t n = std::min(size, static_cast<size_t>(end_ - pos_));
+
+		std::memcpy(p, pos_, n);
+
+		pos_ += n;
+		p += n;
+		size -= n;
+	}
+}
+
+uint8_t
+asset_reader::read_uint8()
+{
+	if (pos_ == end_)
+		fill();
+
+	return *pos_++;
+}
+
+uint16_t
+asset_reader::read_uint16()
+{
+	uint16_t v;
+	read_uint16(&v, 1);
+	return v;
+}
+
+uint32_t
+asset_reader::read_uint32()
+{
+	uint32_t v;
+	read_uint32(&v, 1);
+	return v;
+}
+
+float
+asset_reader::read_float()
+{
+	float v;
+	read_float(&v, 1);
+	return v;
+}
+
+void
+asset_reader::read_uint16(uint16_t *dest, size_t count)
+{
+	read(dest, count*sizeof *dest);
+	from_little_endian(dest, count);
+}
+
+void
+asset_reader::read_uint32(uint32_t *dest, size_t count)
+{
+	read(dest, count*sizeof *dest);
+	from_little_endian(dest, count);
+}
+
+void
+asset_reader::read_float(float *dest, size_t count)
+{
+	// IEEE 754 singles, so only the byte order may need fixing
+	read(dest, count*sizeof *dest);
+	from_little_endian(reinterpret_cast<uint32_t *>(dest), count);
+}
+
+}
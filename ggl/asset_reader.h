@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ggl/noncopyable.h>
+
+namespace ggl {
+
+class asset;
+
+// buffered little-endian decoding of binary assets. reads straight from
+// memory if the asset is already there (see asset::data), and decodes
+// whole arrays with a single copy. panics on short reads
+
+class asset_reader : private noncopyable
+{
+public:
+	asset_reader(asset& a);
+
+	uint8_t read_uint8();
+	uint16_t read_uint16();
+	uint32_t read_uint32();
+	float read_float();
+
+	void read_uint16(uint16_t *dest, size_t count);
+	void read_uint32(uint32_t *dest, size_t count);
+	void read_float(float *dest, size_t count);
+
+	void read(void *dest, size_t size);
+
+private:
+	void fill();
+
+	asset& asset_;
+	const char *pos_, *end_;
+	std::vector<char> buffer_; // unused for in-memory assets
+};
+
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#define O_BINARY 0
+#endif
+
+#include <ggl/panic.h>
+#include <ggl/asset.h>
+#include <ggl/bundle.h>
+
+namespace ggl {
+
+namespace {
+
+const uint32_t BUNDLE_MAGIC = 'G' | ('G' << 8) | ('L' << 16) | ('B' << 24);
+const uint32_t BUNDLE_VERSION = 1;
+
+const size_t HEADER_SIZE = 3*sizeof(uint32_t);
+const size_t TOC_ENTRY_SIZE = 4*sizeof(uint32_t);
+
+uint32_t
+read_uint32(const char *p)
+{
+	auto b = reinterpret_cast<const uint8_t *>(p);
+	return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+class bundle_asset : public asset
+{
+public:
+	bundle_asset(const char *data, size_t size)
+	: data_ { data }
+	, size_ { size }
+	, pos_ { 0 }
+	{ }
+
+	off_t size() const override
+	{ return size_; }
+
+	size_t read(void *buf, size_t size) override
+	{
+		size = std::min(size, size_ - pos_);
+		std::memcpy(buf, data_ + pos_, size);
+		pos_ += size;
+		return size;
+	}
+
+	const char *data() const override
+	{ return data_; }
+
+private:
+	const char *data_;
+	size_t size_;
+	size_t pos_;
+};
+
+} // (anonymous namespace)
+
+bundle::bundle(const std::string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_BINARY);
+	if (fd < 0)
+		panic("failed to open `%s'", path.c_str());
+
+	struct stat st;
+	if (fstat(fd, &st) < 0)
+		panic("failed to stat `%s'", path.c_str());
+
+	size_ = st.st_size;
+
+#ifndef _WIN32
+	void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	if (p == MAP_FAILED)
+		panic("failed to map `%s'", path.c_str());
+#else
+	// no mmap, read it all up front
+	char *p = new char[size_];
+
+	if (::read(fd, p, size_) != static_cast<ssize_t>(size_))
+		panic("failed to read `%s'", path.c_str());
+#endif
+
+	close(fd);
+
+	base_ = static_cast<const char *>(p);
+
+	if (size_ < HEADER_SIZE || read_uint32(base_) != BUNDLE_MAGIC)
+		panic("%s: not a bundle", path.c_str());
+
+	if (read_uint32(base_ + 4) != BUNDLE_VERSION)
+		panic("%s: unsupported bundle version", path.c_str());
+
+	num_entries_ = read_uint32(base_ + 8);
+	toc_ = base_ + HEADER_SIZE;
+
+	if (HEADER_SIZE + num_entries_*TOC_ENTRY_SIZE > size_)
+		panic("%s: truncated bundle", path.c_str());
+}
+
+bundle::~bundle()
+{
+#ifndef _WIN32
+	munmap(const_cast<char *>(base_), size_);
+#else
+	delete[] base_;
+#endif
+}
+
+const char *
+bundle::get_name(unsigned index) const
+{
+	return base_ + read_uint32(toc_ + index*TOC_ENTRY_SIZE);
+}
+
+std::unique_ptr<asset>
+bundle::get_asset(const std::string& path) const
+{
+	// binary search on the sorted toc
+
+	unsigned lo = 0, hi = num_entries_;
+
+	while (lo < hi) {
+		unsigned mid = lo + (hi - lo)/2;
+
+		int cmp = std::strcmp(get_name(mid), path.c_str());
+
+		if (cmp == 0) {
+			const char *entry = toc_ + mid*TOC_ENTRY_SIZE;
+
+			const uint32_t offset = read_uint32(entry + 8);
+			const uint32_t size = read_uint32(entry + 12);
+
+			return std::unique_ptr<asset>(new bundle_asset(base_ + offset, size));
+		}
+
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return nullptr;
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <ggl/noncopyable.h>
+
+namespace ggl {
+
+class asset;
+
+// a read-only, memory-mapped asset archive written by assets/packbundle.pl.
+// assets are handed out as views into the mapping, nothing is copied or
+// decompressed
+//
+// layout (all integers are little-endian uint32):
+//
+//   header   magic "GGLB", version, number of entries
+//   toc      { name offset, name size, data offset, data size } per entry,
+//            sorted by name
+//   names    NUL-terminated
+//   data     each entry aligned to 16 bytes and followed by at least one
+//            NUL
+
+class bundle : private noncopyable
+{
+public:
+	bundle(const std::string& path);
+	~bundle();
+
+	// nullptr if there's no such asset in the bundle
+	std::unique_ptr<asset> get_asset(const std::string& path) const;
+
+private:
+	const char *get_name(unsigned index) const;
+
+	const char *base_;
+	size_t size_;
+	unsigned num_entries_;
+	const char *toc_;
+};
+
+}
@@ -1,5 +1,7 @@
 #include <ggl/resources.h>
 #include <ggl/render.h>
+#include <ggl/gl_state.h>
+#include <ggl/loader.h>
 #include <ggl/core.h>
 
 namespace ggl {
@@ -45,6 +47,8 @@ core::get_pointer_motion_event()
 void
 core::init_resources() const
 {
+	gl_state::reset();
+	loader::init();
 	res::init();
 	render::init();
 }
@@ -59,6 +63,7 @@ core::on_pause() const
 void
 core::on_resume() const
 {
+	gl_state::reset();
 	res::load_gl_resources();
 	render::init();
 }
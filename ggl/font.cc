@@ -10,6 +10,7 @@
 #include <ggl/asset.h>
 #include <ggl/texture.h>
 #include <ggl/resources.h>
+#include <ggl/texture_atlas.h>
 #include <ggl/util.h>
 #include <ggl/render.h>
 #include <ggl/font.h>
@@ -25,21 +26,21 @@ glyph::glyph(const texture *tex, int u, int v, int width, int height, int left,
 
 font::font(const std::string& path)
 {
-	auto xml = g_core->get_asset(path)->read_all();
+	auto asset = g_core->get_asset(path);
 
 	TiXmlDocument doc;
-	doc.Parse(&xml[0]);
+	doc.Parse(asset->read_text());
 
 	auto root_el = doc.RootElement();
 
 	// texture
 
-	std::vector<const texture *> textures;
+	std::vector<const texture_region *> pages;
 
 	if (auto textures_el = root_el->FirstChildElement("textures")) {
 		for (auto node = textures_el->FirstChild(); node; node = node->NextSibling()) {
 			if (auto el = node->ToElement())
-				textures.push_back(res::get_texture(el->Attribute("path")));
+				pages.push_back(res::get_texture_region(el->Attribute("path")));
 		}
 	}
 	// glyphs
@@ -67,7 +68,7 @@ font::font(const std::string& path)
 			int top = atoi(el->Attribute("top"));
 			int advance_x = atoi(el->Attribute("advancex"));
 
-			glyph_map_[code] = new glyph { textures[tex], u, v, width, height, left, top, advance_x };
+			glyph_map_[code] = new glyph { pages[tex]->tex, pages[tex]->origin.x + u, pages[tex]->origin.y + v, width, height, left, top, advance_x };
 		}
 	}
 }
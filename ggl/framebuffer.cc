@@ -1,11 +1,15 @@
+#include <cassert>
+
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 #include <ggl/texture.h>
 #include <ggl/framebuffer.h>
 
 namespace ggl {
 
-framebuffer::framebuffer(int width, int height)
+framebuffer::framebuffer(int width, int height, bool with_id_buffer)
 : render_target { width, height }
+, id_texture_id_ { 0 }
 {
 	// initialize texture
 
@@ -30,11 +34,35 @@ framebuffer::framebuffer(int width, int height)
 
 	bind();
 	gl_check(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_id_, 0));
+
+	if (with_id_buffer) {
+		gl_check(glGenTextures(1, &id_texture_id_));
+
+		bind_id_texture();
+
+		gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+		gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+		gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+		gl_check(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width_, height_, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr));
+
+		gl_check(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, id_texture_id_, 0));
+	}
+
 	unbind();
 }
 
 framebuffer::~framebuffer()
 {
+	if (gl_state::get_framebuffer() == fbo_id_)
+		gl_state::bind_framebuffer(0);
+
+	if (id_texture_id_) {
+		gl_state::forget_texture(id_texture_id_);
+		gl_check(glDeleteTextures(1, &id_texture_id_));
+	}
+
 	gl_check(glDeleteFramebuffers(1, &fbo_id_));
 }
 
@@ -42,19 +70,35 @@ void
 framebuffer::bind() const
 {
 	gl_check(glViewport(0, 0, width_, height_));
-	gl_check(glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_));
+	gl_state::bind_framebuffer(fbo_id_);
 }
 
 void
 framebuffer::unbind()
 {
-	gl_check(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+	gl_state::bind_framebuffer(0);
 }
 
 void
 framebuffer::bind_texture() const
 {
-	gl_check(glBindTexture(GL_TEXTURE_2D, texture_id_));
+	gl_state::bind_texture(texture_id_);
+}
+
+void
+framebuffer::bind_id_texture() const
+{
+	assert(id_texture_id_);
+	gl_state::bind_texture(id_texture_id_);
+}
+
+void
+framebuffer::clear_id_buffer() const
+{
+	static const GLfloat zero[] = { 0, 0, 0, 0 };
+
+	assert(id_texture_id_);
+	gl_check(glClearBufferfv(GL_COLOR, 1, zero));
 }
 
 }
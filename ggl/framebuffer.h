@@ -11,18 +11,24 @@ class texture;
 class framebuffer : public render_target
 {
 public:
-	framebuffer(int width, int height);
+	// with_id_buffer adds a second, single-channel colour attachment that
+	// meshes write object ids to (see render::mesh_outline::POST_PROCESS)
+	framebuffer(int width, int height, bool with_id_buffer = false);
 	~framebuffer();
 
 	void bind() const override;
 	static void unbind();
 
 	void bind_texture() const;
+	void bind_id_texture() const;
+
+	void clear_id_buffer() const; // must be bound
 
 private:
 	void init_texture();
 
 	GLuint texture_id_;
+	GLuint id_texture_id_; // 0 if there's no id buffer
 	GLuint fbo_id_;
 };
 
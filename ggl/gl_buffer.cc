@@ -1,4 +1,5 @@
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 #include <ggl/gl_buffer.h>
 
 namespace ggl {
@@ -11,19 +12,26 @@ gl_buffer::gl_buffer(GLenum target)
 
 gl_buffer::~gl_buffer()
 {
+	gl_state::forget_buffer(id_);
 	gl_check(glDeleteBuffers(1, &id_));
 }
 
 void
 gl_buffer::bind() const
 {
-	gl_check(glBindBuffer(target_, id_));
+	gl_state::bind_buffer(target_, id_);
 }
 
 void
 gl_buffer::unbind() const
 {
-	gl_check(glBindBuffer(target_, 0));
+	gl_state::bind_buffer(target_, 0);
+}
+
+void
+gl_buffer::bind_base(GLuint index) const
+{
+	gl_state::bind_buffer_base(target_, index, id_);
 }
 
 void
@@ -32,6 +40,12 @@ gl_buffer::buffer_data(GLsizei size, const void *data, GLenum usage) const
 	gl_check(glBufferData(target_, size, data, usage));
 }
 
+void
+gl_buffer::buffer_sub_data(GLintptr offset, GLsizei size, const void *data) const
+{
+	gl_check(glBufferSubData(target_, offset, size, data));
+}
+
 void *
 gl_buffer::map_range(GLintptr offset, GLsizei length, GLbitfield access) const
 {
@@ -14,7 +14,11 @@ public:
 	void bind() const;
 	void unbind() const;
 
+	// for indexed targets (GL_UNIFORM_BUFFER)
+	void bind_base(GLuint index) const;
+
 	void buffer_data(GLsizei size, const void *data, GLenum usage) const;
+	void buffer_sub_data(GLintptr offset, GLsizei size, const void *data) const;
 
 	void *map_range(GLintptr offset, GLsizei length, GLbitfield access) const;
 	void unmap() const;
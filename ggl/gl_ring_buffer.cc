@@ -0,0 +1,109 @@
+#include <cassert>
+
+#include <ggl/gl_check.h>
+#include <ggl/gl_ring_buffer.h>
+
+namespace ggl {
+
+gl_ring_buffer::gl_ring_buffer(GLenum target, GLsizei size, int num_segments)
+: buffer_ { target }
+, size_ { size }
+, segment_size_ { size/num_segments }
+, num_segments_ { num_segments }
+, cur_segment_ { 0 }
+, offset_ { 0 }
+{
+	assert(num_segments > 1 && num_segments <= static_cast<int>(sizeof(fences_)/sizeof(*fences_)));
+
+	for (auto& fence : fences_)
+		fence = nullptr;
+
+	buffer_.bind();
+	buffer_.buffer_data(size_, nullptr, GL_DYNAMIC_DRAW);
+	buffer_.unbind();
+}
+
+gl_ring_buffer::~gl_ring_buffer()
+{
+	for (auto fence : fences_) {
+		if (fence)
+			gl_check(glDeleteSync(fence));
+	}
+}
+
+void
+gl_ring_buffer::bind() const
+{
+	buffer_.bind();
+}
+
+void
+gl_ring_buffer::unbind() const
+{
+	buffer_.unbind();
+}
+
+void *
+gl_ring_buffer::map(GLsizei size, GLsizei alignment, GLintptr& offset)
+{
+	assert(size <= segment_size_);
+
+	GLintptr start = ((offset_ + alignment - 1)/alignment)*alignment;
+
+	// ranges never straddle two segments. a segment's fence is inserted
+	// when we move past it, and has to come after every draw that reads
+	// from the segment; the draws reading this range haven't been issued
+	// yet, so the range must not reach into a segment we're leaving
+
+	const int first_segment = start/segment_size_;
+
+	if ((start + size - 1)/segment_size_ != first_segment)
+		start = (((first_segment + 1)*segment_size_ + alignment - 1)/alignment)*alignment;
+
+	if (start + size > num_segments_*segment_size_)
+		start = 0;
+
+	assert((start + size - 1)/segment_size_ == start/segment_size_);
+
+	// fence the segments we're done with, and make sure the GPU is done
+	// with the one we're about to write to
+
+	const int segment = start/segment_size_;
+
+	while (cur_segment_ != segment)
+		enter_next_segment();
+
+	offset_ = start + size;
+	offset = start;
+
+	return buffer_.map_range(start, size, GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT|GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void
+gl_ring_buffer::unmap() const
+{
+	buffer_.unmap();
+}
+
+void
+gl_ring_buffer::enter_next_segment()
+{
+	fences_[cur_segment_] = gl_check_r(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+	cur_segment_ = (cur_segment_ + 1)%num_segments_;
+
+	auto& fence = fences_[cur_segment_];
+
+	if (fence) {
+		GLenum status;
+
+		do {
+			status = gl_check_r(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+		} while (status == GL_TIMEOUT_EXPIRED);
+
+		gl_check(glDeleteSync(fence));
+		fence = nullptr;
+	}
+}
+
+}
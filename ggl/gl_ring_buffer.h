@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ggl/gl.h>
+#include <ggl/noncopyable.h>
+#include <ggl/gl_buffer.h>
+
+namespace ggl {
+
+// a buffer for data that is rewritten every frame. ranges are handed out
+// front to back and mapped unsynchronized, so writing a batch doesn't wait
+// for the draws of previous batches. the storage is split into segments;
+// a fence is inserted when we leave a segment, and waited on (if the GPU
+// is still behind) before we write into it again.
+
+class gl_ring_buffer : private noncopyable
+{
+public:
+	gl_ring_buffer(GLenum target, GLsizei size, int num_segments = 3);
+	~gl_ring_buffer();
+
+	void bind() const;
+	void unbind() const;
+
+	// size must not be larger than a segment; ranges never span two
+	// segments. offset is set to the start of the mapped range, a multiple
+	// of alignment
+	void *map(GLsizei size, GLsizei alignment, GLintptr& offset);
+	void unmap() const;
+
+private:
+	void enter_next_segment();
+
+	gl_buffer buffer_;
+	GLsizei size_;
+	GLsizei segment_size_;
+	int num_segments_;
+	int cur_segment_;
+	GLintptr offset_; // end of the last range handed out
+	GLsync fences_[8];
+};
+
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <iterator>
+
+#include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
+
+namespace ggl { namespace gl_state {
+
+namespace {
+
+const int MAX_TEXTURE_UNITS = 4;
+
+enum { ARRAY_BUFFER, ELEMENT_ARRAY_BUFFER, UNIFORM_BUFFER, NUM_BUFFER_TARGETS };
+
+// the element array binding belongs to the vertex array, so it's unknown
+// after a vertex array change
+const GLuint UNKNOWN = ~0u;
+
+struct state
+{
+	GLuint program;
+	GLenum active_texture;
+	GLuint textures[MAX_TEXTURE_UNITS];
+	GLuint vertex_array;
+	GLuint buffers[NUM_BUFFER_TARGETS];
+	GLuint framebuffer;
+	bool blend;
+	GLenum blend_sfactor, blend_dfactor;
+} cur;
+
+unsigned elided_calls, last_frame_elided_calls;
+
+int
+buffer_slot(GLenum target)
+{
+	switch (target) {
+		case GL_ARRAY_BUFFER:
+			return ARRAY_BUFFER;
+
+		case GL_ELEMENT_ARRAY_BUFFER:
+			return ELEMENT_ARRAY_BUFFER;
+
+		case GL_UNIFORM_BUFFER:
+			return UNIFORM_BUFFER;
+
+		default:
+			return -1;
+	}
+}
+
+bool
+changed(GLuint& cached, GLuint id)
+{
+	if (cached == id) {
+		++elided_calls;
+		return false;
+	}
+
+	cached = id;
+	return true;
+}
+
+} // (anonymous namespace)
+
+void
+reset()
+{
+	cur.program = 0;
+	cur.active_texture = GL_TEXTURE0;
+	std::fill(std::begin(cur.textures), std::end(cur.textures), 0);
+	cur.vertex_array = 0;
+	std::fill(std::begin(cur.buffers), std::end(cur.buffers), 0);
+	cur.framebuffer = 0;
+	cur.blend = false;
+	cur.blend_sfactor = GL_ONE;
+	cur.blend_dfactor = GL_ZERO;
+}
+
+void
+use_program(GLuint id)
+{
+	if (changed(cur.program, id))
+		gl_check(glUseProgram(id));
+}
+
+void
+active_texture(GLenum unit)
+{
+	if (changed(cur.active_texture, unit))
+		gl_check(glActiveTexture(unit));
+}
+
+void
+bind_texture(GLuint id)
+{
+	const unsigned unit = cur.active_texture - GL_TEXTURE0;
+
+	if (unit >= MAX_TEXTURE_UNITS || changed(cur.textures[unit], id))
+		gl_check(glBindTexture(GL_TEXTURE_2D, id));
+}
+
+void
+bind_vertex_array(GLuint id)
+{
+	if (changed(cur.vertex_array, id)) {
+		gl_check(glBindVertexArray(id));
+		cur.buffers[ELEMENT_ARRAY_BUFFER] = UNKNOWN;
+	}
+}
+
+void
+bind_buffer(GLenum target, GLuint id)
+{
+	const int slot = buffer_slot(target);
+
+	if (slot == -1 || changed(cur.buffers[slot], id))
+		gl_check(glBindBuffer(target, id));
+}
+
+void
+bind_framebuffer(GLuint id)
+{
+	if (changed(cur.framebuffer, id))
+		gl_check(glBindFramebuffer(GL_FRAMEBUFFER, id));
+}
+
+GLuint
+get_framebuffer()
+{
+	return cur.framebuffer;
+}
+
+void
+bind_buffer_base(GLenum target, GLuint index, GLuint id)
+{
+	// also binds the generic binding point
+	gl_check(glBindBufferBase(target, index, id));
+
+	const int slot = buffer_slot(target);
+	if (slot != -1)
+		cur.buffers[slot] = id;
+}
+
+void
+enable_blend(GLenum sfactor, GLenum dfactor)
+{
+	if (!cur.blend) {
+		gl_check(glEnable(GL_BLEND));
+		cur.blend = true;
+	} else {
+		++elided_calls;
+	}
+
+	if (sfactor != cur.blend_sfactor || dfactor != cur.blend_dfactor) {
+		gl_check(glBlendFunc(sfactor, dfactor));
+		cur.blend_sfactor = sfactor;
+		cur.blend_dfactor = dfactor;
+	} else {
+		++elided_calls;
+	}
+}
+
+void
+disable_blend()
+{
+	if (cur.blend) {
+		gl_check(glDisable(GL_BLEND));
+		cur.blend = false;
+	} else {
+		++elided_calls;
+	}
+}
+
+void
+forget_program(GLuint id)
+{
+	if (cur.program == id)
+		cur.program = UNKNOWN;
+}
+
+void
+forget_texture(GLuint id)
+{
+	// deleting a bound texture binds 0 in its place
+	for (auto& texture : cur.textures) {
+		if (texture == id)
+			texture = 0;
+	}
+}
+
+void
+forget_vertex_array(GLuint id)
+{
+	if (cur.vertex_array == id) {
+		cur.vertex_array = 0;
+		cur.buffers[ELEMENT_ARRAY_BUFFER] = UNKNOWN;
+	}
+}
+
+void
+forget_buffer(GLuint id)
+{
+	for (auto& buffer : cur.buffers) {
+		if (buffer == id)
+			buffer = 0;
+	}
+}
+
+void
+end_frame()
+{
+	last_frame_elided_calls = elided_calls;
+	elided_calls = 0;
+}
+
+unsigned
+get_elided_call_count()
+{
+	return last_frame_elided_calls;
+}
+
+} }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ggl/gl.h>
+
+namespace ggl { namespace gl_state {
+
+// binds and blend state go through here, so calls that wouldn't change
+// anything can be skipped. GL objects must be bound only through these
+// functions (or the wrappers that use them), or the cache goes stale
+
+void
+reset(); // GL defaults; after the context is created
+
+void
+use_program(GLuint id);
+
+void
+active_texture(GLenum unit);
+
+void
+bind_texture(GLuint id); // GL_TEXTURE_2D on the active unit
+
+void
+bind_vertex_array(GLuint id);
+
+void
+bind_buffer(GLenum target, GLuint id);
+
+void
+bind_framebuffer(GLuint id);
+
+GLuint
+get_framebuffer();
+
+void
+bind_buffer_base(GLenum target, GLuint index, GLuint id);
+
+void
+enable_blend(GLenum sfactor, GLenum dfactor);
+
+void
+disable_blend();
+
+// call before deleting objects, so a later object reusing the name isn't
+// mistaken for a bound one
+
+void
+forget_program(GLuint id);
+
+void
+forget_texture(GLuint id);
+
+void
+forget_vertex_array(GLuint id);
+
+void
+forget_buffer(GLuint id);
+
+void
+end_frame();
+
+// calls skipped during the last frame
+unsigned
+get_elided_call_count();
+
+} }
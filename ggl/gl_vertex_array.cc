@@ -1,4 +1,5 @@
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 #include <ggl/gl_vertex_array.h>
 
 namespace ggl {
@@ -10,19 +11,20 @@ gl_vertex_array::gl_vertex_array()
 
 gl_vertex_array::~gl_vertex_array()
 {
+	gl_state::forget_vertex_array(id_);
 	gl_check(glDeleteVertexArrays(1, &id_));
 }
 
 void
 gl_vertex_array::bind() const
 {
-	gl_check(glBindVertexArray(id_));
+	gl_state::bind_vertex_array(id_);
 }
 
 void
 gl_vertex_array::unbind()
 {
-	gl_check(glBindVertexArray(0));
+	gl_state::bind_vertex_array(0);
 }
 
 }
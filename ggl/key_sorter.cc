@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+
+#include <ggl/key_sorter.h>
+
+namespace ggl {
+
+namespace {
+
+const int HASH_BITS = 9;
+const size_t HASH_SIZE = 1 << HASH_BITS; // at most half full
+
+static_assert(HASH_SIZE >= 2*key_sorter::MAX_DISTINCT_KEYS, "hash table too small");
+
+} // (anonymous namespace)
+
+void
+key_sorter::sort(std::vector<sort_entry>& entries)
+{
+	const size_t num_entries = entries.size();
+
+	if (num_entries < 2)
+		return;
+
+	// give each distinct key a bucket. primitives are mostly queued in runs
+	// with the same key, so only look up keys that change
+
+	std::array<uint64_t, HASH_SIZE> hash_keys;
+	std::array<int, HASH_SIZE> hash_buckets;
+	hash_buckets.fill(-1);
+
+	bucket_keys_.clear();
+	entry_buckets_.resize(num_entries);
+
+	int bucket = -1;
+
+	for (size_t i = 0; i < num_entries; i++) {
+		const uint64_t key = entries[i].key;
+
+		if (bucket == -1 || key != entries[i - 1].key) {
+			size_t slot = (key*0x9e3779b97f4a7c15ull) >> (64 - HASH_BITS);
+
+			while (hash_buckets[slot] != -1 && hash_keys[slot] != key)
+				slot = (slot + 1) & (HASH_SIZE - 1);
+
+			if (hash_buckets[slot] == -1) {
+				if (bucket_keys_.size() == MAX_DISTINCT_KEYS) {
+					std::stable_sort(
+						std::begin(entries),
+						std::end(entries),
+						[](const sort_entry& a, const sort_entry& b)
+						{
+							return a.key < b.key;
+						});
+
+					return;
+				}
+
+				hash_keys[slot] = key;
+				hash_buckets[slot] = bucket_keys_.size();
+				bucket_keys_.push_back(key);
+			}
+
+			bucket = hash_buckets[slot];
+		}
+
+		entry_buckets_[i] = bucket;
+	}
+
+	// order buckets by key and find where each one starts
+
+	const size_t num_buckets = bucket_keys_.size();
+
+	std::array<uint32_t, MAX_DISTINCT_KEYS> order;
+	std::array<size_t, MAX_DISTINCT_KEYS> bucket_start;
+
+	for (size_t i = 0; i < num_buckets; i++) {
+		order[i] = i;
+		bucket_start[i] = 0;
+	}
+
+	std::sort(
+		std::begin(order),
+		std::begin(order) + num_buckets,
+		[this](uint32_t a, uint32_t b)
+		{
+			return bucket_keys_[a] < bucket_keys_[b];
+		});
+
+	for (size_t i = 0; i < num_entries; i++)
+		++bucket_start[entry_buckets_[i]];
+
+	size_t offset = 0;
+
+	for (size_t i = 0; i < num_buckets; i++) {
+		const size_t count = bucket_start[order[i]];
+		bucket_start[order[i]] = offset;
+		offset += count;
+	}
+
+	// entries keep their relative order within a bucket
+
+	scratch_.resize(num_entries);
+
+	for (size_t i = 0; i < num_entries; i++)
+		scratch_[bucket_start[entry_buckets_[i]]++] = entries[i];
+
+	entries.swap(scratch_);
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <ggl/noncopyable.h>
+
+namespace ggl {
+
+struct sort_entry
+{
+	uint64_t key;
+	uint32_t index; // of the queued item
+};
+
+// stable sort by key, for queues with few distinct keys (a frame's sprites
+// come in a handful of depths and materials). each distinct key gets a
+// bucket and entries are counted into place in two passes. falls back to
+// std::stable_sort if there are more than MAX_DISTINCT_KEYS keys.
+
+class key_sorter : private noncopyable
+{
+public:
+	static const size_t MAX_DISTINCT_KEYS = 256;
+
+	void sort(std::vector<sort_entry>& entries);
+
+private:
+	std::vector<sort_entry> scratch_;
+	std::vector<uint32_t> entry_buckets_;
+	std::vector<uint64_t> bucket_keys_;
+};
+
+}
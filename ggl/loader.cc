@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <ggl/loader.h>
+
+namespace ggl { namespace loader {
+
+struct job
+{
+	enum class state { QUEUED, WORKING, WORKED, DONE };
+
+	std::function<void()> work;
+	std::function<void()> done;
+	state st;
+};
+
+namespace {
+
+std::mutex mutex;
+std::condition_variable queued_cond, worked_cond;
+
+std::deque<job_ptr> queued_jobs, worked_jobs;
+
+std::thread loader_thread;
+bool stopping;
+
+void
+run_loader()
+{
+	std::unique_lock<std::mutex> lock { mutex };
+
+	for (;;) {
+		queued_cond.wait(lock, [] { return stopping || !queued_jobs.empty(); });
+
+		if (stopping)
+			break;
+
+		auto j = queued_jobs.front();
+		queued_jobs.pop_front();
+		j->st = job::state::WORKING;
+
+		lock.unlock();
+		j->work();
+		lock.lock();
+
+		j->st = job::state::WORKED;
+		worked_jobs.push_back(j);
+		worked_cond.notify_all();
+	}
+}
+
+} // (anonymous namespace)
+
+void
+init()
+{
+	stopping = false;
+	loader_thread = std::thread { run_loader };
+}
+
+void
+shutdown()
+{
+	if (!loader_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock { mutex };
+		stopping = true;
+	}
+
+	queued_cond.notify_one();
+	loader_thread.join();
+
+	queued_jobs.clear();
+	worked_jobs.clear();
+}
+
+job_ptr
+enqueue(std::function<void()> work, std::function<void()> done)
+{
+	job_ptr j { new job { std::move(work), std::move(done), job::state::QUEUED } };
+
+	{
+		std::lock_guard<std::mutex> lock { mutex };
+		queued_jobs.push_back(j);
+	}
+
+	queued_cond.notify_one();
+
+	return j;
+}
+
+void
+complete(const job_ptr& job_ref)
+{
+	// job_ref may belong to something that j->done() destroys (a pending
+	// resource erasing itself once loaded), so hold on to the job here
+	const job_ptr j = job_ref;
+
+	{
+		std::unique_lock<std::mutex> lock { mutex };
+
+		switch (j->st) {
+			case job::state::DONE:
+				return;
+
+			case job::state::QUEUED:
+				queued_jobs.erase(std::find(std::begin(queued_jobs), std::end(queued_jobs), j));
+				j->st = job::state::WORKING;
+
+				lock.unlock();
+				j->work();
+				lock.lock();
+				break;
+
+			case job::state::WORKING:
+				worked_cond.wait(lock, [&] { return j->st != job::state::WORKING; });
+				// FALLTHROUGH
+
+			case job::state::WORKED:
+				worked_jobs.erase(std::find(std::begin(worked_jobs), std::end(worked_jobs), j));
+				break;
+		}
+
+		j->st = job::state::DONE;
+	}
+
+	j->done();
+}
+
+void
+poll()
+{
+	using clock = std::chrono::steady_clock;
+
+	const auto deadline = clock::now() + std::chrono::duration<float>(FRAME_BUDGET);
+
+	do {
+		job_ptr j;
+
+		{
+			std::lock_guard<std::mutex> lock { mutex };
+
+			if (worked_jobs.empty())
+				break;
+
+			j = worked_jobs.front();
+			worked_jobs.pop_front();
+			j->st = job::state::DONE;
+		}
+
+		j->done();
+	} while (clock::now() < deadline);
+}
+
+} }
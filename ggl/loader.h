@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace ggl { namespace loader {
+
+// background jobs for asset loading. each job has a work part, run on the
+// loader thread (file I/O, decoding; no GL), and a done part, run on the
+// main thread once the work is finished (GL uploads)
+
+struct job;
+using job_ptr = std::shared_ptr<job>;
+
+void
+init();
+
+void
+shutdown();
+
+job_ptr
+enqueue(std::function<void()> work, std::function<void()> done);
+
+// finishes j right away, running its work on this thread if the loader
+// thread hasn't started it yet
+void
+complete(const job_ptr& j);
+
+// runs the done parts of finished jobs until they're all done or about
+// FRAME_BUDGET has been spent; once per frame, from the main thread
+void
+poll();
+
+const float FRAME_BUDGET = 2e-3; // seconds
+
+} }
@@ -1,111 +1,166 @@
 #include <ggl/panic.h>
 #include <ggl/core.h>
 #include <ggl/asset.h>
+#include <ggl/asset_reader.h>
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 
 #include "mesh.h"
 
 namespace ggl {
 
+namespace {
+
+// interleaved vertex layout, as uploaded to the GL. both mesh file versions
+// store vertices like this, version 2 files can be uploaded as they are
+struct gl_vertex {
+	GLfloat position[3];
+	GLfloat normal[3];
+	GLfloat vnormal[3];
+	GLfloat color[3];
+};
+
+const size_t VERTEX_FLOATS = sizeof(gl_vertex)/sizeof(GLfloat);
+
+// version 1: uint16 vertex count, vertices, uint16 triangle count, triangles
+const uint32_t MESH_V1_MAGIC = 'M' | ('E' << 8) | ('S' << 16) | ('H' << 24);
+
+// version 2: uint32 vertex count, uint32 index count, a reserved uint32,
+// then the vertex and index blobs, vertices 16-byte aligned
+const uint32_t MESH_V2_MAGIC = 'M' | ('S' << 8) | ('H' << 16) | ('2' << 24);
+const size_t MESH_V2_HEADER_SIZE = 4*sizeof(uint32_t);
+
+bool keep_data = true;
+
+} // (anonymous namespace)
+
 mesh::mesh(const std::string& path)
+: path_ { path }
+, keep_data_ { keep_data }
 {
-	load(path);
 	load();
 }
 
+mesh::mesh(const std::string& path, asset& a)
+: path_ { path }
+, keep_data_ { keep_data }
+{
+	load(a);
+}
+
 mesh::~mesh()
 {
 	unload();
 }
 
 void
-mesh::load(const std::string& path)
+mesh::set_keep_data(bool keep)
 {
-	auto a = g_core->get_asset(path);
-
-	uint32_t sig = a->read_uint32();
-	if (sig != ('M' | ('E' << 8) | ('S' << 16) | ('H' << 24)))
-		panic("%s: not a mesh", path.c_str());
-
-	uint16_t num_verts = a->read_uint16();
-	verts_.reserve(num_verts);
-
-	for (unsigned i = 0; i < num_verts; i++) {
-		auto read_vec3 = [&]() -> vec3
-		{
-			float x = a->read_float();
-			float y = a->read_float();
-			float z = a->read_float();
+	keep_data = keep;
+}
 
-			return { x, y, z };
-		};
+size_t
+mesh::get_data_size() const
+{
+	return vertex_data_.size()*sizeof(GLfloat) + index_data_.size()*sizeof(GLushort);
+}
 
-		vec3 pos = read_vec3();
-		vec3 normal = read_vec3();
-		vec3 vnormal = read_vec3();
-		vec3 color = read_vec3();
+size_t
+mesh::get_gl_size() const
+{
+	return num_verts_*sizeof(gl_vertex) + num_indices_*sizeof(GLushort);
+}
 
-		verts_.push_back({ pos, normal, vnormal, color });
+void
+mesh::load()
+{
+	if (!vertex_data_.empty()) {
+		load(&vertex_data_[0], &index_data_[0]);
+		return;
 	}
 
-	uint16_t num_tris = a->read_uint16();
-	tris_.reserve(num_tris);
-
-	for (unsigned i = 0; i < num_tris; i++) {
-		int v0 = a->read_uint16();
-		int v1 = a->read_uint16();
-		int v2 = a->read_uint16();
-		tris_.push_back({ v0, v1, v2 });
-	}
+	load(*g_core->get_asset(path_));
 }
 
 void
-mesh::load()
+mesh::load(asset& a)
 {
-	struct gl_vertex {
-		gl_vertex()
-		{ }
+	asset_reader r { a };
 
-		gl_vertex(const vertex& v)
-		: position { v.pos.x, v.pos.y, v.pos.z }
-		, normal { v.normal.x, v.normal.y, v.normal.z }
-		, vnormal { v.vnormal.x, v.vnormal.y, v.vnormal.z }
-		, color { v.color.x, v.color.y, v.color.z }
-		{ }
+	std::vector<GLfloat> vertex_data;
+	std::vector<GLushort> index_data;
 
-		GLfloat position[3];
-		GLfloat normal[3];
-		GLfloat vnormal[3];
-		GLfloat color[3];
-	};
+	uint32_t sig = r.read_uint32();
 
-	std::vector<gl_vertex> gl_verts(std::begin(verts_), std::end(verts_));
+	if (sig == MESH_V2_MAGIC) {
+		const uint64_t num_verts = r.read_uint32();
+		const uint64_t num_indices = r.read_uint32();
+		r.read_uint32();
 
-	gl_check(glGenBuffers(1, &vertex_buffer_));
+		// the blobs may be used in place, check they're really there
+		if (MESH_V2_HEADER_SIZE + num_verts*sizeof(gl_vertex) + num_indices*sizeof(GLushort) > static_cast<uint64_t>(a.size()))
+			panic("%s: truncated mesh", path_.c_str());
 
-	gl_check(glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_));
-	gl_check(glBufferData(GL_ARRAY_BUFFER, gl_verts.size()*sizeof(gl_vertex), &gl_verts[0], GL_STATIC_DRAW));
-	gl_check(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		num_verts_ = num_verts;
+		num_indices_ = num_indices;
 
-	gl_check(glGenBuffers(1, &index_buffer_));
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (a.data() && !keep_data_) {
+			// upload straight from the asset's memory (e.g. a mapped bundle)
+			auto verts = a.data() + MESH_V2_HEADER_SIZE;
+			auto indices = verts + num_verts_*sizeof(gl_vertex);
+
+			load(reinterpret_cast<const GLfloat *>(verts), reinterpret_cast<const GLushort *>(indices));
+			return;
+		}
+#endif
+
+		vertex_data.resize(num_verts_*VERTEX_FLOATS);
+		r.read_float(vertex_data.data(), vertex_data.size());
+
+		index_data.resize(num_indices_);
+		r.read_uint16(index_data.data(), index_data.size());
+	} else if (sig == MESH_V1_MAGIC) {
+		num_verts_ = r.read_uint16();
+
+		vertex_data.resize(num_verts_*VERTEX_FLOATS);
+		r.read_float(vertex_data.data(), vertex_data.size());
 
-	std::vector<GLushort> indices;
-	indices.reserve(3*tris_.size());
+		num_indices_ = 3*r.read_uint16();
 
-	for (auto& t : tris_) {
-		indices.push_back(t.v0);
-		indices.push_back(t.v1);
-		indices.push_back(t.v2);
+		index_data.resize(num_indices_);
+		r.read_uint16(index_data.data(), index_data.size());
+	} else {
+		panic("%s: not a mesh", path_.c_str());
 	}
 
-	gl_check(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_));
-	gl_check(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(GLushort), &indices[0], GL_STATIC_DRAW));
-	gl_check(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+	load(vertex_data.data(), index_data.data());
+
+	if (keep_data_) {
+		vertex_data_.swap(vertex_data);
+		index_data_.swap(index_data);
+	}
+}
+
+void
+mesh::load(const GLfloat *vertex_data, const GLushort *index_data)
+{
+	gl_check(glGenBuffers(1, &vertex_buffer_));
+
+	gl_state::bind_buffer(GL_ARRAY_BUFFER, vertex_buffer_);
+	gl_check(glBufferData(GL_ARRAY_BUFFER, num_verts_*sizeof(gl_vertex), vertex_data, GL_STATIC_DRAW));
+	gl_state::bind_buffer(GL_ARRAY_BUFFER, 0);
+
+	gl_check(glGenBuffers(1, &index_buffer_));
+
+	gl_state::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+	gl_check(glBufferData(GL_ELEMENT_ARRAY_BUFFER, num_indices_*sizeof(GLushort), index_data, GL_STATIC_DRAW));
+	gl_state::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 	gl_check(glGenVertexArrays(1, &vao_id_));
-	gl_check(glBindVertexArray(vao_id_));
+	gl_state::bind_vertex_array(vao_id_);
 
-	gl_check(glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_));
+	gl_state::bind_buffer(GL_ARRAY_BUFFER, vertex_buffer_);
 
 #define ENABLE_ATTRIB(location, size, field) \
 	gl_check(glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, sizeof(gl_vertex), reinterpret_cast<const GLvoid *>(offsetof(gl_vertex, field)))); \
@@ -118,26 +173,42 @@ mesh::load()
 
 #undef ENABLE_ATTRIB
 
-	gl_check(glBindBuffer(GL_ARRAY_BUFFER, 0));
-	gl_check(glBindVertexArray(0));
+	// modelview matrix rows, per instance; pointed at the instance data in
+	// draw_instanced
+
+	for (GLuint location = 4; location < 7; location++) {
+		gl_check(glEnableVertexAttribArray(location));
+		gl_check(glVertexAttribDivisor(location, 1));
+	}
+
+	gl_state::bind_buffer(GL_ARRAY_BUFFER, 0);
+	gl_state::bind_vertex_array(0);
 }
 
 void
 mesh::unload()
 {
+	gl_state::forget_vertex_array(vao_id_);
+	gl_state::forget_buffer(vertex_buffer_);
+	gl_state::forget_buffer(index_buffer_);
+
 	gl_check(glDeleteVertexArrays(1, &vao_id_));
 	gl_check(glDeleteBuffers(1, &vertex_buffer_));
 	gl_check(glDeleteBuffers(1, &index_buffer_));
 }
 
 void
-mesh::draw() const
+mesh::draw_instanced(GLintptr offset, GLsizei count) const
 {
-	gl_check(glBindVertexArray(vao_id_));
-	gl_check(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_));
-	gl_check(glDrawElements(GL_TRIANGLES, 3*tris_.size(), GL_UNSIGNED_SHORT, 0));
-	gl_check(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-	gl_check(glBindVertexArray(0));
+	gl_state::bind_vertex_array(vao_id_);
+
+	for (GLuint i = 0; i < 3; i++)
+		gl_check(glVertexAttribPointer(4 + i, 4, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, reinterpret_cast<const GLvoid *>(offset + i*4*sizeof(GLfloat))));
+
+	gl_state::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+	gl_check(glDrawElementsInstanced(GL_TRIANGLES, num_indices_, GL_UNSIGNED_SHORT, 0, count));
+	gl_state::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	gl_state::bind_vertex_array(0);
 }
 
 }
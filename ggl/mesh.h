@@ -6,36 +6,47 @@
 #include <ggl/gl.h>
 #include <ggl/noncopyable.h>
 
-#include "vec3.h"
-
 namespace ggl {
 
+class asset;
+
 class mesh : private noncopyable
 {
 public:
 	mesh(const std::string& path);
+	mesh(const std::string& path, asset& a); // a already opened, e.g. by the loader
 	~mesh();
 
-	void draw() const;
+	// draws count instances. their modelview matrices are read from the
+	// buffer bound to GL_ARRAY_BUFFER at offset, as the first three rows of
+	// each matrix (see INSTANCE_STRIDE)
+	void draw_instanced(GLintptr offset, GLsizei count) const;
+
+	static const GLsizei INSTANCE_STRIDE = 12*sizeof(GLfloat);
 
 	void load();
 	void unload();
 
+	// if false, the vertex and index data are dropped once uploaded and
+	// load() reads the mesh again from its asset (e.g. after the GL
+	// context is lost). true by default; affects meshes loaded afterwards
+	static void set_keep_data(bool keep);
+
+	// bytes held in memory and in the GL
+	size_t get_data_size() const;
+	size_t get_gl_size() const;
+
 private:
-	void load(const std::string& path);
-
-	struct vertex {
-		vec3 pos;
-		vec3 normal;
-		vec3 vnormal;
-		vec3 color;
-	};
-	std::vector<vertex> verts_;
-
-	struct triangle {
-		int v0, v1, v2;
-	};
-	std::vector<triangle> tris_;
+	void load(asset& a);
+	void load(const GLfloat *vertex_data, const GLushort *index_data);
+
+	std::string path_;
+
+	bool keep_data_;
+	std::vector<GLfloat> vertex_data_; // gl_vertex layout (see mesh.cc)
+	std::vector<GLushort> index_data_;
+
+	GLsizei num_verts_, num_indices_;
 
 	GLuint vertex_buffer_, index_buffer_;
 	GLuint vao_id_;
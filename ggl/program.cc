@@ -1,10 +1,13 @@
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 #include <ggl/core.h>
 #include <ggl/asset.h>
 #include <ggl/log.h>
 #include <ggl/panic.h>
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 #include <ggl/program.h>
 
 namespace ggl {
@@ -107,10 +110,9 @@ program::load()
 
 			shader s { type };
 
-			auto data = g_core->get_asset(path)->read_all();
-			data.push_back('\0');
+			auto asset = g_core->get_asset(path);
 
-			s.set_source(&data[0]);
+			s.set_source(asset->read_text());
 			s.compile();
 
 			gl_check(glAttachShader(id_, s.id));
@@ -126,22 +128,82 @@ program::load()
 
 	if (!status)
 		panic("failed to link shader\n%s", get_info_log().c_str());
+
+	load_uniform_locations();
 }
 
 void
 program::unload()
 {
+	gl_state::forget_program(id_);
 	gl_check(glDeleteProgram(id_));
 	id_ = 0;
 }
 
+void
+program::load_uniform_locations()
+{
+	if (uniform_names_.empty()) {
+		GLint num_uniforms;
+		gl_check(glGetProgramiv(id_, GL_ACTIVE_UNIFORMS, &num_uniforms));
+
+		GLint max_length;
+		gl_check(glGetProgramiv(id_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+
+		std::vector<GLchar> name(max_length + 1);
+
+		for (GLint i = 0; i < num_uniforms; i++) {
+			GLsizei length;
+			GLint size;
+			GLenum type;
+			gl_check(glGetActiveUniform(id_, i, name.size(), &length, &size, &type, &name[0]));
+
+			std::string uniform_name(&name[0], length);
+
+			// arrays are reported as "name[0]"
+			auto bracket = uniform_name.find('[');
+			if (bracket != std::string::npos)
+				uniform_name.erase(bracket);
+
+			uniform_names_.push_back(uniform_name);
+		}
+
+		std::sort(std::begin(uniform_names_), std::end(uniform_names_));
+	}
+
+	// members of uniform blocks have no location (-1)
+
+	uniform_locations_.clear();
+
+	for (auto& name : uniform_names_)
+		uniform_locations_.push_back(gl_check_r(glGetUniformLocation(id_, name.c_str())));
+
+	// shared uniform blocks
+
+	GLuint transforms_index = gl_check_r(glGetUniformBlockIndex(id_, "transforms"));
+	if (transforms_index != GL_INVALID_INDEX)
+		gl_check(glUniformBlockBinding(id_, transforms_index, TRANSFORMS_BINDING));
+}
+
+program::uniform
+program::get_uniform(const GLchar *name) const
+{
+	auto it = std::lower_bound(
+			std::begin(uniform_names_),
+			std::end(uniform_names_),
+			name,
+			[](const std::string& a, const GLchar *b) { return std::strcmp(a.c_str(), b) < 0; });
+
+	if (it == std::end(uniform_names_) || *it != name || uniform_locations_[it - std::begin(uniform_names_)] == -1)
+		panic("get_uniform failed for %s\n", name);
+
+	return { static_cast<unsigned>(it - std::begin(uniform_names_)) };
+}
+
 GLint
 program::get_uniform_location(const GLchar *name) const
 {
-	GLint rv = gl_check_r(glGetUniformLocation(id_, name));
-	if (rv == -1)
-		panic("get_uniform_location failed for %s\n", name);
-	return rv;
+	return location(get_uniform(name));
 }
 
 GLint
@@ -153,70 +215,130 @@ program::get_attribute_location(const GLchar *name) const
 	return rv;
 }
 
+void
+program::set_uniform_f(uniform u, GLfloat v0) const
+{
+	gl_check(glUniform1f(location(u), v0));
+}
+
+void
+program::set_uniform_f(uniform u, GLfloat v0, GLfloat v1) const
+{
+	gl_check(glUniform2f(location(u), v0, v1));
+}
+
+void
+program::set_uniform_f(uniform u, GLfloat v0, GLfloat v1, GLfloat v2) const
+{
+	gl_check(glUniform3f(location(u), v0, v1, v2));
+}
+
+void
+program::set_uniform_f(uniform u, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) const
+{
+	gl_check(glUniform4f(location(u), v0, v1, v2, v3));
+}
+
+void
+program::set_uniform_i(uniform u, GLint v0) const
+{
+	gl_check(glUniform1i(location(u), v0));
+}
+
+void
+program::set_uniform_i(uniform u, GLint v0, GLint v1) const
+{
+	gl_check(glUniform2i(location(u), v0, v1));
+}
+
+void
+program::set_uniform_i(uniform u, GLint v0, GLint v1, GLint v2) const
+{
+	gl_check(glUniform3i(location(u), v0, v1, v2));
+}
+
+void
+program::set_uniform_i(uniform u, GLint v0, GLint v1, GLint v2, GLint v3) const
+{
+	gl_check(glUniform4i(location(u), v0, v1, v2, v3));
+}
+
+void
+program::set_uniform_mat4(uniform u, const mat4& mat) const
+{
+	GLfloat gl_matrix[16] = {
+		mat.m11, mat.m12, mat.m13, mat.m14,
+		mat.m21, mat.m22, mat.m23, mat.m24,
+		mat.m31, mat.m32, mat.m33, mat.m34,
+		0, 0, 0, 1 };
+
+	gl_check(glUniformMatrix4fv(location(u), 1, 1, gl_matrix));
+}
+
+void
+program::set_uniform_mat4(uniform u, const GLfloat *mat) const
+{
+	gl_check(glUniformMatrix4fv(location(u), 1, 1, mat));
+}
+
 void
 program::set_uniform_f(const GLchar *name, GLfloat v0) const
 {
-	gl_check(glUniform1f(get_uniform_location(name), v0));
+	set_uniform_f(get_uniform(name), v0);
 }
 
 void
 program::set_uniform_f(const GLchar *name, GLfloat v0, GLfloat v1) const
 {
-	gl_check(glUniform2f(get_uniform_location(name), v0, v1));
+	set_uniform_f(get_uniform(name), v0, v1);
 }
 
 void
 program::set_uniform_f(const GLchar *name, GLfloat v0, GLfloat v1, GLfloat v2) const
 {
-	gl_check(glUniform3f(get_uniform_location(name), v0, v1, v2));
+	set_uniform_f(get_uniform(name), v0, v1, v2);
 }
 
 void
 program::set_uniform_f(const GLchar *name, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) const
 {
-	gl_check(glUniform4f(get_uniform_location(name), v0, v1, v2, v3));
+	set_uniform_f(get_uniform(name), v0, v1, v2, v3);
 }
 
 void
 program::set_uniform_i(const GLchar *name, GLint v0) const
 {
-	gl_check(glUniform1i(get_uniform_location(name), v0));
+	set_uniform_i(get_uniform(name), v0);
 }
 
 void
 program::set_uniform_i(const GLchar *name, GLint v0, GLint v1) const
 {
-	gl_check(glUniform2i(get_uniform_location(name), v0, v1));
+	set_uniform_i(get_uniform(name), v0, v1);
 }
 
 void
 program::set_uniform_i(const GLchar *name, GLint v0, GLint v1, GLint v2) const
 {
-	gl_check(glUniform3i(get_uniform_location(name), v0, v1, v2));
+	set_uniform_i(get_uniform(name), v0, v1, v2);
 }
 
 void
 program::set_uniform_i(const GLchar *name, GLint v0, GLint v1, GLint v2, GLint v3) const
 {
-	gl_check(glUniform4i(get_uniform_location(name), v0, v1, v2, v3));
+	set_uniform_i(get_uniform(name), v0, v1, v2, v3);
 }
 
 void
 program::set_uniform_mat4(const GLchar *name, const mat4& mat) const
 {
-	GLfloat gl_matrix[16] = {
-		mat.m11, mat.m12, mat.m13, mat.m14,
-		mat.m21, mat.m22, mat.m23, mat.m24,
-		mat.m31, mat.m32, mat.m33, mat.m34,
-		0, 0, 0, 1 };
-
-	gl_check(glUniformMatrix4fv(get_uniform_location(name), 1, 1, gl_matrix));
+	set_uniform_mat4(get_uniform(name), mat);
 }
 
 void
 program::set_uniform_mat4(const GLchar *name, const GLfloat *mat) const
 {
-	gl_check(glUniformMatrix4fv(get_uniform_location(name), 1, 1, mat));
+	set_uniform_mat4(get_uniform(name), mat);
 }
 
 void
@@ -228,7 +350,7 @@ program::parameter_i(GLenum name, GLint value)
 void
 program::use() const
 {
-	gl_check(glUseProgram(id_));
+	gl_state::use_program(id_);
 }
 
 std::string
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <ggl/noncopyable.h>
 #include <ggl/gl.h>
@@ -9,15 +10,45 @@
 
 namespace ggl {
 
+// binding points of uniform blocks shared by all programs
+
+enum uniform_block_binding : GLuint
+{
+	TRANSFORMS_BINDING, // block "transforms": proj_modelview (ortho) and proj_matrix (perspective)
+};
+
 class program : private noncopyable
 {
 public:
 	program(const std::string& vp_path, const std::string& fp_path);
 	~program();
 
+	// uniform locations are looked up once, when the program is linked. a
+	// handle stays valid when the program is reloaded after a context loss
+
+	struct uniform
+	{
+		unsigned index;
+	};
+
+	uniform get_uniform(const GLchar *name) const;
+
 	GLint get_uniform_location(const GLchar *name) const;
 	GLint get_attribute_location(const GLchar *name) const;
 
+	void set_uniform_f(uniform u, GLfloat v0) const;
+	void set_uniform_f(uniform u, GLfloat v0, GLfloat v1) const;
+	void set_uniform_f(uniform u, GLfloat v0, GLfloat v1, GLfloat v2) const;
+	void set_uniform_f(uniform u, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) const;
+
+	void set_uniform_i(uniform u, GLint v0) const;
+	void set_uniform_i(uniform u, GLint v0, GLint v1) const;
+	void set_uniform_i(uniform u, GLint v0, GLint v1, GLint v2) const;
+	void set_uniform_i(uniform u, GLint v0, GLint v1, GLint v2, GLint v3) const;
+
+	void set_uniform_mat4(uniform u, const mat4& mat) const;
+	void set_uniform_mat4(uniform u, const GLfloat *mat) const;
+
 	void set_uniform_f(const GLchar *name, GLfloat v0) const;
 	void set_uniform_f(const GLchar *name, GLfloat v0, GLfloat v1) const;
 	void set_uniform_f(const GLchar *name, GLfloat v0, GLfloat v1, GLfloat v2) const;
@@ -40,8 +71,14 @@ public:
 
 private:
 	std::string get_info_log() const;
+	void load_uniform_locations();
+
+	GLint location(uniform u) const
+	{ return uniform_locations_[u.index]; }
 
 	GLuint id_;
+	std::vector<std::string> uniform_names_; // sorted, fixed after the first load
+	std::vector<GLint> uniform_locations_; // parallel to uniform_names_
 	std::string vp_path_;
 	std::string fp_path_;
 };
@@ -58,10 +58,10 @@ parse_program(TiXmlNode *node)
 void
 program_manager::load_programs(const std::string& path)
 {
-	auto xml = g_core->get_asset(path)->read_all();
+	auto asset = g_core->get_asset(path);
 
 	TiXmlDocument doc;
-	doc.Parse(&xml[0]);
+	doc.Parse(asset->read_text());
 
 	auto root_el = doc.RootElement();
 
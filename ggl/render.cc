@@ -1,5 +1,8 @@
 #include <algorithm>
 #include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
 #include <stack>
 #include <memory>
 #include <cassert>
@@ -14,6 +17,9 @@
 #include <ggl/mesh.h>
 #include <ggl/gl_vertex_array.h>
 #include <ggl/gl_buffer.h>
+#include <ggl/gl_ring_buffer.h>
+#include <ggl/gl_state.h>
+#include <ggl/key_sorter.h>
 #include <ggl/program.h>
 #include <ggl/util.h>
 #include <ggl/gl_buffer.h>
@@ -28,24 +34,87 @@ namespace {
 const size_t INDICES_PER_SPRITE = 6;
 const size_t VERTS_PER_SPRITE = 4;
 
+// colours are normalized bytes and sprite sheet texcoords normalized shorts.
+// the second texture of multi-textured quads scrolls (see shiny_sprite), so
+// its texcoords stay floats
+
 struct gl_vertex_color {
 	GLfloat position[2];
-	GLfloat color[4];
+	GLubyte color[4];
 };
 
 struct gl_vertex_single {
 	GLfloat position[2];
-	GLfloat texcoord[2];
-	GLfloat color[4];
+	GLushort texcoord[2];
+	GLubyte color[4];
 };
 
 struct gl_vertex_multi {
 	GLfloat position[2];
-	GLfloat texcoord0[2];
+	GLushort texcoord0[2];
 	GLfloat texcoord1[2];
-	GLfloat color[4];
+	GLubyte color[4];
+};
+
+// a textured parallelogram, drawn as an instance of the unit quad
+
+struct gl_instance_single {
+	GLfloat origin[2]; // p0
+	GLfloat axis_s[2]; // p3 - p0
+	GLfloat axis_t[2]; // p1 - p0
+	GLushort tex_rect[4];
+	GLubyte color[4];
 };
 
+bool
+is_parallelogram(const quad& q)
+{
+	const float EPSILON = 1e-3f;
+
+	const vec2f d = (q.p1 + q.p3) - (q.p0 + q.p2);
+	return std::fabs(d.x) < EPSILON && std::fabs(d.y) < EPSILON;
+}
+
+GLubyte
+to_color_byte(float c)
+{
+	return static_cast<GLubyte>(std::min(std::max(c, 0.f), 1.f)*255.f + .5f);
+}
+
+GLushort
+to_texcoord_short(float t)
+{
+	assert(t >= 0.f && t <= 1.f);
+	return static_cast<GLushort>(std::min(std::max(t, 0.f), 1.f)*65535.f + .5f);
+}
+
+// quads are streamed into the vertex ring buffer in batches of at most
+// MAX_BATCH_SPRITES, one batch of the largest vertex type per segment.
+// INDEX_BUFFER_SPRITES covers a buffer full of the smallest vertex type.
+
+const size_t MAX_BATCH_SPRITES = 1024;
+const int VERT_BUFFER_SEGMENTS = 4;
+const size_t VERT_BUFFER_SIZE = VERT_BUFFER_SEGMENTS*MAX_BATCH_SPRITES*VERTS_PER_SPRITE*sizeof(gl_vertex_multi);
+const size_t INDEX_BUFFER_SPRITES = VERT_BUFFER_SIZE/(VERTS_PER_SPRITE*sizeof(gl_vertex_color));
+
+static_assert(INDEX_BUFFER_SPRITES*VERTS_PER_SPRITE <= 65536, "indices must fit in a GLushort");
+
+// primitives are sorted by a 64-bit key: depth in the high 32 bits, then
+// primitive type, then a per-frame material (texture or mesh) id.
+
+uint32_t
+depth_sort_bits(float depth)
+{
+	// map floats to unsigned ints with the same ordering
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof bits);
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+mesh_outline mesh_outline_mode = mesh_outline::GEOMETRY; // outlives the renderer
+
+unsigned draw_calls, last_frame_draw_calls; // summed over all begin()/end() pairs
+
 } // (anonymous namespace)
 
 class renderer : private noncopyable
@@ -111,6 +180,7 @@ private:
 
 	// textured quads
 	void render_quads(const texture *tex, const primitive_info *const *sprites, size_t num_sprites);
+	void render_quads_instanced(const primitive_info *const *sprites, size_t num_sprites);
 
 	// 2-textured quads
 	void render_quads(const texture *tex0, const texture *tex1, const primitive_info *const *sprites, size_t num_sprites);
@@ -118,27 +188,50 @@ private:
 	// meshes
 	void render_meshes(const primitive_info *const *meshes, size_t num_meshes);
 
+	void add_sort_key(const primitive_info& p);
+	uint32_t get_material_id(const void *m0, const void *m1);
+
 	rgba color_;
 	mat3 matrix_;
 	std::stack<mat3> matrix_stack_;
 
-	static const int SPRITE_QUEUE_CAPACITY = 1024;
+	template <typename VertexType>
+	VertexType *map_quads(size_t num_sprites);
+	void draw_quads(size_t num_sprites);
 
-	int sprite_queue_size_;
-	primitive_info sprite_queue_[SPRITE_QUEUE_CAPACITY];
+	size_t batch_first_sprite_; // slot of the batch last mapped
 
-	gl_buffer vert_buffer_;
+
+	GLint next_mesh_id_; // for mesh_outline::POST_PROCESS, wraps around at 255
+
+	std::vector<primitive_info> sprite_queue_; // grows as needed, never shrinks
+	std::vector<const primitive_info *> sorted_sprites_;
+
+	std::vector<sort_entry> sort_entries_; // parallel to sprite_queue_ until sorted
+	key_sorter sorter_;
+
+	// textures or meshes seen this frame, indexed by material id
+	std::vector<std::pair<const void *, const void *>> materials_;
+
+	gl_ring_buffer vert_buffer_;
 	gl_buffer index_buffer_;
+	gl_buffer unit_quad_buffer_;
+	gl_buffer transforms_buffer_; // uniform block shared by all programs
 
 	gl_vertex_array vao_color_;
 	gl_vertex_array vao_single_;
 	gl_vertex_array vao_multi_;
+	gl_vertex_array vao_instanced_;
 
 	const program *prog_color_;
 	const program *prog_single_;
 	const program *prog_multi_;
+	const program *prog_instanced_;
 	const program *prog_mesh_;
 	const program *prog_mesh_outline_;
+	const program *prog_mesh_id_;
+
+	program::uniform mesh_id_base_uniform_;
 
 	bbox viewport_;
 	std::array<GLfloat, 16> ortho_proj_;
@@ -146,13 +239,19 @@ private:
 } *g_renderer;
 
 renderer::renderer()
-: vert_buffer_ { GL_ARRAY_BUFFER }
+: next_mesh_id_ { 0 }
+, vert_buffer_ { GL_ARRAY_BUFFER, VERT_BUFFER_SIZE, VERT_BUFFER_SEGMENTS }
 , index_buffer_ { GL_ELEMENT_ARRAY_BUFFER }
+, unit_quad_buffer_ { GL_ARRAY_BUFFER }
+, transforms_buffer_ { GL_UNIFORM_BUFFER }
 , prog_color_ { res::get_program("color") }
 , prog_single_ { res::get_program("texture-color") }
 , prog_multi_ { res::get_program("bitexture-color") }
+, prog_instanced_ { res::get_program("texture-color-instanced") }
 , prog_mesh_ { res::get_program("mesh") }
 , prog_mesh_outline_ { res::get_program("mesh-outline") }
+, prog_mesh_id_ { res::get_program("mesh-id") }
+, mesh_id_base_uniform_ ( prog_mesh_id_->get_uniform("id_base") )
 {
 	init_buffers();
 	init_vaos();
@@ -160,9 +259,16 @@ renderer::renderer()
 	prog_single_->use();
 	prog_single_->set_uniform_i("tex", 0); // texunit 0
 
+	prog_instanced_->use();
+	prog_instanced_->set_uniform_i("tex", 0); // texunit 0
+
 	prog_multi_->use();
 	prog_multi_->set_uniform_i("tex0", 0); // texunit 0
 	prog_multi_->set_uniform_i("tex1", 1); // texunit 0
+
+	prog_mesh_outline_->use();
+	prog_mesh_outline_->set_uniform_f("offs", .25);
+	prog_mesh_outline_->set_uniform_f("color", 0, 0, 0, 1);
 }
 
 void
@@ -193,14 +299,9 @@ renderer::init_ortho_proj()
 			0, 0, c, tz,
 			0, 0, 0, 1 };
 
-	prog_color_->use();
-	prog_color_->set_uniform_mat4("proj_modelview", &ortho_proj_[0]);
-
-	prog_single_->use();
-	prog_single_->set_uniform_mat4("proj_modelview", &ortho_proj_[0]);
-
-	prog_multi_->use();
-	prog_multi_->set_uniform_mat4("proj_modelview", &ortho_proj_[0]);
+	transforms_buffer_.bind();
+	transforms_buffer_.buffer_sub_data(0, sizeof(ortho_proj_), &ortho_proj_[0]);
+	transforms_buffer_.unbind();
 }
 
 void
@@ -224,11 +325,9 @@ renderer::init_perspective_proj()
 			      0, 1, (Z_FAR + Z_NEAR)/(Z_NEAR - Z_FAR), -1,
 			      0, 0, (2.f*Z_FAR*Z_NEAR)/(Z_NEAR - Z_FAR), 0 };
 
-	prog_mesh_->use();
-	prog_mesh_->set_uniform_mat4("proj_matrix", &perspective_proj_[0]);
-
-	prog_mesh_outline_->use();
-	prog_mesh_outline_->set_uniform_mat4("proj_matrix", &perspective_proj_[0]);
+	transforms_buffer_.bind();
+	transforms_buffer_.buffer_sub_data(sizeof(ortho_proj_), sizeof(perspective_proj_), &perspective_proj_[0]);
+	transforms_buffer_.unbind();
 }
 
 bbox
@@ -240,22 +339,16 @@ renderer::get_viewport() const
 void
 renderer::init_buffers()
 {
-	// vertex buffer
+	// index buffer (the vertex buffer allocates its own storage)
 
-	vert_buffer_.bind();
-	vert_buffer_.buffer_data(SPRITE_QUEUE_CAPACITY*VERTS_PER_SPRITE*sizeof(gl_vertex_multi), nullptr, GL_DYNAMIC_DRAW);
-	vert_buffer_.unbind();
-
-	// index buffer
-
-	GLsizei index_buffer_size = SPRITE_QUEUE_CAPACITY*INDICES_PER_SPRITE*sizeof(GLushort);
+	GLsizei index_buffer_size = INDEX_BUFFER_SPRITES*INDICES_PER_SPRITE*sizeof(GLushort);
 
 	index_buffer_.bind();
 	index_buffer_.buffer_data(index_buffer_size, nullptr, GL_DYNAMIC_DRAW);
 
 	auto index_ptr = reinterpret_cast<GLushort *>(index_buffer_.map_range(0, index_buffer_size, GL_MAP_WRITE_BIT));
 
-	for (int i = 0; i < SPRITE_QUEUE_CAPACITY; i++) {
+	for (size_t i = 0; i < INDEX_BUFFER_SPRITES; i++) {
 		*index_ptr++ = i*4;
 		*index_ptr++ = i*4 + 1;
 		*index_ptr++ = i*4 + 2;
@@ -267,36 +360,67 @@ renderer::init_buffers()
 
 	index_buffer_.unmap();
 	index_buffer_.unbind();
+
+	// unit quad, in the same corner order as quad
+
+	static const GLfloat unit_quad[] = { 0, 0, 0, 1, 1, 1, 1, 0 };
+
+	unit_quad_buffer_.bind();
+	unit_quad_buffer_.buffer_data(sizeof(unit_quad), unit_quad, GL_STATIC_DRAW);
+	unit_quad_buffer_.unbind();
+
+	// projection matrices, filled in by set_viewport. std140 row-major
+	// mat4s are 16 packed floats
+
+	transforms_buffer_.bind();
+	transforms_buffer_.buffer_data(sizeof(ortho_proj_) + sizeof(perspective_proj_), nullptr, GL_DYNAMIC_DRAW);
+	transforms_buffer_.unbind();
+
+	transforms_buffer_.bind_base(TRANSFORMS_BINDING);
 }
 
 void
 renderer::init_vaos()
 {
-#define ENABLE_ATTRIB(location, size, vt, field) \
-	gl_check(glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, sizeof(vt), reinterpret_cast<const GLvoid *>(offsetof(vt, field)))); \
+#define ENABLE_ATTRIB(location, size, type, normalized, vt, field) \
+	gl_check(glVertexAttribPointer(location, size, type, normalized, sizeof(vt), reinterpret_cast<const GLvoid *>(offsetof(vt, field)))); \
 	gl_check(glEnableVertexAttribArray(location));
 
 	vao_color_.bind();
 	vert_buffer_.bind();
-	ENABLE_ATTRIB(0, 2, gl_vertex_color, position)
-	ENABLE_ATTRIB(1, 4, gl_vertex_color, color)
+	ENABLE_ATTRIB(0, 2, GL_FLOAT, GL_FALSE, gl_vertex_color, position)
+	ENABLE_ATTRIB(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, gl_vertex_color, color)
 	vert_buffer_.unbind();
 
 	vao_single_.bind();
 	vert_buffer_.bind();
-	ENABLE_ATTRIB(0, 2, gl_vertex_single, position)
-	ENABLE_ATTRIB(1, 2, gl_vertex_single, texcoord)
-	ENABLE_ATTRIB(2, 4, gl_vertex_single, color)
+	ENABLE_ATTRIB(0, 2, GL_FLOAT, GL_FALSE, gl_vertex_single, position)
+	ENABLE_ATTRIB(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, gl_vertex_single, texcoord)
+	ENABLE_ATTRIB(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, gl_vertex_single, color)
 	vert_buffer_.unbind();
 
 	vao_multi_.bind();
 	vert_buffer_.bind();
-	ENABLE_ATTRIB(0, 2, gl_vertex_multi, position)
-	ENABLE_ATTRIB(1, 2, gl_vertex_multi, texcoord0)
-	ENABLE_ATTRIB(2, 2, gl_vertex_multi, texcoord1)
-	ENABLE_ATTRIB(3, 4, gl_vertex_multi, color)
+	ENABLE_ATTRIB(0, 2, GL_FLOAT, GL_FALSE, gl_vertex_multi, position)
+	ENABLE_ATTRIB(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, gl_vertex_multi, texcoord0)
+	ENABLE_ATTRIB(2, 2, GL_FLOAT, GL_FALSE, gl_vertex_multi, texcoord1)
+	ENABLE_ATTRIB(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, gl_vertex_multi, color)
 	vert_buffer_.unbind();
 
+	// the per-instance attributes (1 to 5) are pointed at each batch's
+	// range of the vertex buffer in render_quads_instanced
+
+	vao_instanced_.bind();
+	unit_quad_buffer_.bind();
+	gl_check(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0));
+	gl_check(glEnableVertexAttribArray(0));
+	unit_quad_buffer_.unbind();
+
+	for (GLuint location = 1; location <= 5; location++) {
+		gl_check(glEnableVertexAttribArray(location));
+		gl_check(glVertexAttribDivisor(location, 1));
+	}
+
 #undef ENABLE_ATTRIB
 
 	gl_vertex_array::unbind();
@@ -305,7 +429,11 @@ renderer::init_vaos()
 void
 renderer::begin()
 {
-	sprite_queue_size_ = 0;
+	sprite_queue_.clear();
+	sort_entries_.clear();
+	materials_.clear();
+
+	next_mesh_id_ = 0;
 
 	matrix_ = mat3::identity();
 	color_ = white;
@@ -359,9 +487,8 @@ renderer::get_matrix() const
 void
 renderer::enqueue(const quad& dest_coords, float depth)
 {
-	assert(sprite_queue_size_ < SPRITE_QUEUE_CAPACITY);
-
-	auto p = &sprite_queue_[sprite_queue_size_++];
+	sprite_queue_.emplace_back();
+	auto p = &sprite_queue_.back();
 
 	p->type = primitive_info::QUAD;
 	p->depth = depth;
@@ -371,14 +498,15 @@ renderer::enqueue(const quad& dest_coords, float depth)
 	q.tex1 = nullptr;
 	q.dest_coords = { matrix_*dest_coords.p0, matrix_*dest_coords.p1, matrix_*dest_coords.p2, matrix_*dest_coords.p3 };
 	q.color = color_;
+
+	add_sort_key(*p);
 }
 
 void
 renderer::enqueue(const texture *tex0, const bbox& tex0_coords, const quad& dest_coords, float depth)
 {
-	assert(sprite_queue_size_ < SPRITE_QUEUE_CAPACITY);
-
-	auto p = &sprite_queue_[sprite_queue_size_++];
+	sprite_queue_.emplace_back();
+	auto p = &sprite_queue_.back();
 
 	p->type = primitive_info::QUAD;
 	p->depth = depth;
@@ -389,14 +517,15 @@ renderer::enqueue(const texture *tex0, const bbox& tex0_coords, const quad& dest
 	q.tex0_coords = tex0_coords;
 	q.dest_coords = { matrix_*dest_coords.p0, matrix_*dest_coords.p1, matrix_*dest_coords.p2, matrix_*dest_coords.p3 };
 	q.color = color_;
+
+	add_sort_key(*p);
 }
 
 void
 renderer::enqueue(const texture *tex0, const texture *tex1, const bbox& tex0_coords, const bbox& tex1_coords, const quad& dest_coords, float depth)
 {
-	assert(sprite_queue_size_ < SPRITE_QUEUE_CAPACITY);
-
-	auto p = &sprite_queue_[sprite_queue_size_++];
+	sprite_queue_.emplace_back();
+	auto p = &sprite_queue_.back();
 
 	p->type = primitive_info::QUAD;
 	p->depth = depth;
@@ -408,14 +537,15 @@ renderer::enqueue(const texture *tex0, const texture *tex1, const bbox& tex0_coo
 	q.tex1_coords = tex1_coords;
 	q.dest_coords = { matrix_*dest_coords.p0, matrix_*dest_coords.p1, matrix_*dest_coords.p2, matrix_*dest_coords.p3 };
 	q.color = color_;
+
+	add_sort_key(*p);
 }
 
 void
 renderer::enqueue(const mesh *m, const mat4& mat, float depth)
 {
-	assert(sprite_queue_size_ < SPRITE_QUEUE_CAPACITY);
-
-	auto p = &sprite_queue_[sprite_queue_size_++];
+	sprite_queue_.emplace_back();
+	auto p = &sprite_queue_.back();
 
 	p->type = primitive_info::MESH;
 	p->depth = depth;
@@ -441,47 +571,65 @@ renderer::enqueue(const mesh *m, const mat4& mat, float depth)
 	mi.mat = mat4 { matrix_.m00, matrix_.m01, 0, x,
 		        matrix_.m10, matrix_.m11, 0, y,
 		                  0,           0, 1, PLANE_Z }*mat;
+
+	add_sort_key(*p);
+}
+
+uint32_t
+renderer::get_material_id(const void *m0, const void *m1)
+{
+	// consecutive primitives usually share a material, and there are only a
+	// handful per frame, so a linear search from the back is cheap
+
+	const auto material = std::make_pair(m0, m1);
+
+	for (size_t i = materials_.size(); i > 0; i--) {
+		if (materials_[i - 1] == material)
+			return i - 1;
+	}
+
+	materials_.push_back(material);
+	return materials_.size() - 1;
+}
+
+void
+renderer::add_sort_key(const primitive_info& p)
+{
+	uint32_t material_id;
+
+	if (p.type == primitive_info::QUAD)
+		material_id = get_material_id(p.quad_info.tex0, p.quad_info.tex1);
+	else
+		material_id = get_material_id(p.mesh_info.m, nullptr);
+
+	assert(material_id < 0x80000000u);
+
+	const uint64_t key =
+		(static_cast<uint64_t>(depth_sort_bits(p.depth)) << 32) |
+		(static_cast<uint64_t>(p.type) << 31) |
+		material_id;
+
+	sort_entries_.push_back({ key, static_cast<uint32_t>(sort_entries_.size()) });
 }
 
 void
 renderer::end()
 {
-	if (!sprite_queue_size_)
+	const size_t sprite_queue_size = sprite_queue_.size();
+
+	if (!sprite_queue_size)
 		return;
 
 	// sort sprites
 
-	static const primitive_info *sorted_sprites[SPRITE_QUEUE_CAPACITY];
+	assert(sort_entries_.size() == sprite_queue_size);
 
-	for (size_t i = 0; i < sprite_queue_size_; i++)
-		sorted_sprites[i] = &sprite_queue_[i];
+	sorter_.sort(sort_entries_);
 
-	std::stable_sort(
-		&sorted_sprites[0],
-		&sorted_sprites[sprite_queue_size_],
-		[](const primitive_info *a, const primitive_info *b)
-		{
-			if (a->depth < b->depth) {
-				return true;
-			} else if (a->depth > b->depth) {
-				return false;
-			} else if (a->type < b->type) {
-				return true;
-			} else if (a->type > b->type) {
-				return false;
-			} else {
-				if (a->type == primitive_info::QUAD) {
-					if (a->quad_info.tex0 < b->quad_info.tex0)
-						return true;
-					else if (a->quad_info.tex0 > b->quad_info.tex0)
-						return false;
-					else
-						return a->quad_info.tex1 < b->quad_info.tex1;
-				} else {
-					return a->mesh_info.m < b->mesh_info.m;
-				}
-			}
-		});
+	sorted_sprites_.resize(sprite_queue_size);
+
+	for (size_t i = 0; i < sprite_queue_size; i++)
+		sorted_sprites_[i] = &sprite_queue_[sort_entries_[i].index];
 
 	// do the dance, do the dance
 
@@ -493,22 +641,27 @@ renderer::end()
 
 	auto do_render = [&](size_t end)
 		{
-			const auto start = &sorted_sprites[batch_start];
+			const auto start = &sorted_sprites_[batch_start];
 			const auto num_sprites = end - batch_start;
 
 			if (!num_sprites)
 				return;
 
-			if (batch_primitive_type == primitive_info::MESH) {
-				render_meshes(start, num_sprites);
-			} else {
-				if (batch_tex0 == nullptr) {
+			// flush big batches in chunks that fit in the vertex buffer
+
+			for (size_t i = 0; i < num_sprites; i += MAX_BATCH_SPRITES) {
+				const auto chunk_start = start + i;
+				const auto chunk_size = std::min(num_sprites - i, MAX_BATCH_SPRITES);
+
+				if (batch_primitive_type == primitive_info::MESH) {
+					render_meshes(chunk_start, chunk_size);
+				} else if (batch_tex0 == nullptr) {
 					assert(batch_tex1 == nullptr);
-					render_quads(start, num_sprites);
+					render_quads(chunk_start, chunk_size);
 				} else if (batch_tex1 == nullptr) {
-					render_quads(batch_tex0, start, num_sprites);
+					render_quads(batch_tex0, chunk_start, chunk_size);
 				} else {
-					render_quads(batch_tex0, batch_tex1, start, num_sprites);
+					render_quads(batch_tex0, batch_tex1, chunk_start, chunk_size);
 				}
 			}
 		};
@@ -518,8 +671,8 @@ renderer::end()
 
 	vert_buffer_.bind();
 
-	for (size_t i = 0; i < sprite_queue_size_; i++) {
-		auto sp = sorted_sprites[i];
+	for (size_t i = 0; i < sprite_queue_size; i++) {
+		auto sp = sorted_sprites_[i];
 
 		if (sp->type != batch_primitive_type ||
 		    (sp->type == primitive_info::QUAD && (sp->quad_info.tex0 != batch_tex0 || sp->quad_info.tex1 != batch_tex1))) {
@@ -536,7 +689,7 @@ renderer::end()
 		}
 	}
 
-	do_render(sprite_queue_size_);
+	do_render(sprite_queue_size);
 	}
 
 	// cleanup
@@ -546,21 +699,54 @@ renderer::end()
 
 	gl_vertex_array::unbind();
 
-	gl_check(glActiveTexture(GL_TEXTURE0));
+	gl_state::active_texture(GL_TEXTURE0);
+}
+
+template <typename VertexType>
+VertexType *
+renderer::map_quads(size_t num_sprites)
+{
+	assert(num_sprites <= MAX_BATCH_SPRITES);
+
+	// ranges are aligned to a whole quad of this type, so index i*6 of the
+	// index buffer points at the first vertex of the quad at slot i
+
+	const size_t quad_size = VERTS_PER_SPRITE*sizeof(VertexType);
+
+	GLintptr offset;
+	auto vert_ptr = vert_buffer_.map(num_sprites*quad_size, quad_size, offset);
+
+	batch_first_sprite_ = offset/quad_size;
+	assert(batch_first_sprite_ + num_sprites <= INDEX_BUFFER_SPRITES);
+
+	return reinterpret_cast<VertexType *>(vert_ptr);
+}
+
+void
+renderer::draw_quads(size_t num_sprites)
+{
+	++draw_calls;
+
+	index_buffer_.bind();
+	gl_check(glDrawElements(
+			GL_TRIANGLES,
+			num_sprites*INDICES_PER_SPRITE,
+			GL_UNSIGNED_SHORT,
+			reinterpret_cast<const GLvoid *>(batch_first_sprite_*INDICES_PER_SPRITE*sizeof(GLushort))));
 }
 
 void
 renderer::render_quads(const texture *tex0, const texture *tex1, const primitive_info *const *sprites, size_t num_sprites)
 {
-	gl_check(glActiveTexture(GL_TEXTURE0));
+	gl_state::active_texture(GL_TEXTURE0);
 	tex0->bind();
 
-	gl_check(glActiveTexture(GL_TEXTURE1));
+	gl_state::active_texture(GL_TEXTURE1);
 	tex1->bind();
 
 	prog_multi_->use();
 
-	auto vert_ptr = reinterpret_cast<gl_vertex_multi *>(vert_buffer_.map_range(0, num_sprites*VERTS_PER_SPRITE*sizeof(gl_vertex_multi), GL_MAP_WRITE_BIT));
+	auto vert_ptr = map_quads<gl_vertex_multi>(num_sprites);
 
 	for (size_t i = 0; i < num_sprites; i++) {
 		auto sp = sprites[i];
@@ -585,11 +771,11 @@ renderer::render_quads(const texture *tex0, const texture *tex1, const primitive
 
 		const auto& tex0_coords = sp->quad_info.tex0_coords;
 
-		const GLfloat u00 = tex0_coords.min.x;
-		const GLfloat u10 = tex0_coords.max.x;
+		const GLushort u00 = to_texcoord_short(tex0_coords.min.x);
+		const GLushort u10 = to_texcoord_short(tex0_coords.max.x);
 
-		const GLfloat v00 = tex0_coords.min.y;
-		const GLfloat v10 = tex0_coords.max.y;
+		const GLushort v00 = to_texcoord_short(tex0_coords.min.y);
+		const GLushort v10 = to_texcoord_short(tex0_coords.max.y);
 
 		const auto& tex1_coords = sp->quad_info.tex1_coords;
 
@@ -601,10 +787,10 @@ renderer::render_quads(const texture *tex0, const texture *tex1, const primitive
 
 		const auto& color = sp->quad_info.color;
 
-		const GLfloat r = color.r;
-		const GLfloat g = color.g;
-		const GLfloat b = color.b;
-		const GLfloat a = color.a;
+		const GLubyte r = to_color_byte(color.r);
+		const GLubyte g = to_color_byte(color.g);
+		const GLubyte b = to_color_byte(color.b);
+		const GLubyte a = to_color_byte(color.a);
 
 		*vert_ptr++ = { { x0, y0 }, { u00, v00 }, { u01, v01 }, { r, g, b, a } };
 		*vert_ptr++ = { { x1, y1 }, { u00, v10 }, { u01, v11 }, { r, g, b, a } };
@@ -615,19 +801,31 @@ renderer::render_quads(const texture *tex0, const texture *tex1, const primitive
 	vert_buffer_.unmap();
 
 	vao_multi_.bind();
-	index_buffer_.bind();
-	gl_check(glDrawElements(GL_TRIANGLES, num_sprites*INDICES_PER_SPRITE, GL_UNSIGNED_SHORT, 0));
+	draw_quads(num_sprites);
 }
 
 void
 renderer::render_quads(const texture *tex, const primitive_info *const *sprites, size_t num_sprites)
 {
-	gl_check(glActiveTexture(GL_TEXTURE0));
+	// sprites, glyphs and particles are parallelograms, which can be drawn
+	// as instances with a fraction of the vertex data
+
+	const bool instanced = std::all_of(
+				sprites,
+				sprites + num_sprites,
+				[](const primitive_info *sp) { return is_parallelogram(sp->quad_info.dest_coords); });
+
+	gl_state::active_texture(GL_TEXTURE0);
 	tex->bind();
 
+	if (instanced) {
+		render_quads_instanced(sprites, num_sprites);
+		return;
+	}
+
 	prog_single_->use();
 
-	auto vert_ptr = reinterpret_cast<gl_vertex_single *>(vert_buffer_.map_range(0, num_sprites*VERTS_PER_SPRITE*sizeof(gl_vertex_single), GL_MAP_WRITE_BIT));
+	auto vert_ptr = map_quads<gl_vertex_single>(num_sprites);
 
 	for (size_t i = 0; i < num_sprites; i++) {
 		auto sp = sprites[i];
@@ -650,18 +848,18 @@ renderer::render_quads(const texture *tex, const primitive_info *const *sprites,
 
 		const auto& tex_coords = sp->quad_info.tex0_coords;
 
-		const GLfloat u0 = tex_coords.min.x;
-		const GLfloat u1 = tex_coords.max.x;
+		const GLushort u0 = to_texcoord_short(tex_coords.min.x);
+		const GLushort u1 = to_texcoord_short(tex_coords.max.x);
 
-		const GLfloat v0 = tex_coords.min.y;
-		const GLfloat v1 = tex_coords.max.y;
+		const GLushort v0 = to_texcoord_short(tex_coords.min.y);
+		const GLushort v1 = to_texcoord_short(tex_coords.max.y);
 
 		const auto& color = sp->quad_info.color;
 
-		const GLfloat r = color.r;
-		const GLfloat g = color.g;
-		const GLfloat b = color.b;
-		const GLfloat a = color.a;
+		const GLubyte r = to_color_byte(color.r);
+		const GLubyte g = to_color_byte(color.g);
+		const GLubyte b = to_color_byte(color.b);
+		const GLubyte a = to_color_byte(color.a);
 
 		*vert_ptr++ = { { x0, y0 }, { u0, v0 }, { r, g, b, a } };
 		*vert_ptr++ = { { x1, y1 }, { u0, v1 }, { r, g, b, a } };
@@ -672,8 +870,59 @@ renderer::render_quads(const texture *tex, const primitive_info *const *sprites,
 	vert_buffer_.unmap();
 
 	vao_single_.bind();
+	draw_quads(num_sprites);
+}
+
+void
+renderer::render_quads_instanced(const primitive_info *const *sprites, size_t num_sprites)
+{
+	prog_instanced_->use();
+
+	GLintptr offset;
+	auto inst_ptr = reinterpret_cast<gl_instance_single *>(vert_buffer_.map(num_sprites*sizeof(gl_instance_single), sizeof(gl_instance_single), offset));
+
+	for (size_t i = 0; i < num_sprites; i++) {
+		auto sp = sprites[i];
+
+		assert(sp->type == primitive_info::QUAD);
+
+		const auto& dest_coords = sp->quad_info.dest_coords;
+
+		const vec2f p0 = dest_coords.p0;
+		const vec2f s = dest_coords.p3 - p0;
+		const vec2f t = dest_coords.p1 - p0;
+
+		const auto& tex_coords = sp->quad_info.tex0_coords;
+
+		const auto& color = sp->quad_info.color;
+
+		*inst_ptr++ = {
+			{ p0.x, p0.y },
+			{ s.x, s.y },
+			{ t.x, t.y },
+			{ to_texcoord_short(tex_coords.min.x), to_texcoord_short(tex_coords.min.y), to_texcoord_short(tex_coords.max.x), to_texcoord_short(tex_coords.max.y) },
+			{ to_color_byte(color.r), to_color_byte(color.g), to_color_byte(color.b), to_color_byte(color.a) } };
+	}
+
+	vert_buffer_.unmap();
+
+	vao_instanced_.bind();
+
+#define INSTANCE_ATTRIB(location, size, type, normalized, field) \
+	gl_check(glVertexAttribPointer(location, size, type, normalized, sizeof(gl_instance_single), reinterpret_cast<const GLvoid *>(offset + offsetof(gl_instance_single, field))));
+
+	INSTANCE_ATTRIB(1, 2, GL_FLOAT, GL_FALSE, origin)
+	INSTANCE_ATTRIB(2, 2, GL_FLOAT, GL_FALSE, axis_s)
+	INSTANCE_ATTRIB(3, 2, GL_FLOAT, GL_FALSE, axis_t)
+	INSTANCE_ATTRIB(4, 4, GL_UNSIGNED_SHORT, GL_TRUE, tex_rect)
+	INSTANCE_ATTRIB(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, color)
+
+#undef INSTANCE_ATTRIB
+
+	++draw_calls;
+
 	index_buffer_.bind();
-	gl_check(glDrawElements(GL_TRIANGLES, num_sprites*INDICES_PER_SPRITE, GL_UNSIGNED_SHORT, 0));
+	gl_check(glDrawElementsInstanced(GL_TRIANGLES, INDICES_PER_SPRITE, GL_UNSIGNED_SHORT, 0, num_sprites));
 }
 
 void
@@ -681,7 +930,7 @@ renderer::render_quads(const primitive_info *const *sprites, size_t num_sprites)
 {
 	prog_color_->use();
 
-	auto vert_ptr = reinterpret_cast<gl_vertex_color *>(vert_buffer_.map_range(0, num_sprites*VERTS_PER_SPRITE*sizeof(gl_vertex_color), GL_MAP_WRITE_BIT));
+	auto vert_ptr = map_quads<gl_vertex_color>(num_sprites);
 
 	for (size_t i = 0; i < num_sprites; i++) {
 		auto sp = sprites[i];
@@ -704,10 +953,10 @@ renderer::render_quads(const primitive_info *const *sprites, size_t num_sprites)
 
 		const auto& color = sp->quad_info.color;
 
-		const GLfloat r = color.r;
-		const GLfloat g = color.g;
-		const GLfloat b = color.b;
-		const GLfloat a = color.a;
+		const GLubyte r = to_color_byte(color.r);
+		const GLubyte g = to_color_byte(color.g);
+		const GLubyte b = to_color_byte(color.b);
+		const GLubyte a = to_color_byte(color.a);
 
 		*vert_ptr++ = { { x0, y0 }, { r, g, b, a } };
 		*vert_ptr++ = { { x1, y1 }, { r, g, b, a } };
@@ -718,47 +967,97 @@ renderer::render_quads(const primitive_info *const *sprites, size_t num_sprites)
 	vert_buffer_.unmap();
 
 	vao_color_.bind();
-	index_buffer_.bind();
-	gl_check(glDrawElements(GL_TRIANGLES, num_sprites*INDICES_PER_SPRITE, GL_UNSIGNED_SHORT, 0));
+	draw_quads(num_sprites);
 }
 
 void
 renderer::render_meshes(const primitive_info *const *meshes, size_t num_meshes)
 {
-	gl_check(glEnable(GL_CULL_FACE));
-
-	// draw outlines
+	// upload the modelview matrices for the whole batch. meshes are sorted
+	// by mesh within each depth, so runs of the same mesh are drawn with
+	// one instanced call per pass
 
-	prog_mesh_outline_->use();
-	prog_mesh_outline_->set_uniform_f("offs", .25);
-	prog_mesh_outline_->set_uniform_f("color", 0, 0, 0, 1);
-
-	gl_check(glFrontFace(GL_CW));
+	GLintptr offset;
+	auto mat_ptr = reinterpret_cast<GLfloat *>(vert_buffer_.map(num_meshes*mesh::INSTANCE_STRIDE, mesh::INSTANCE_STRIDE, offset));
 
 	for (size_t i = 0; i < num_meshes; i++) {
 		auto sp = meshes[i];
 		assert(sp->type == primitive_info::MESH);
 
-		auto& m = sp->mesh_info;
-		prog_mesh_outline_->set_uniform_mat4("modelview_matrix", m.mat);
+		const auto& mat = sp->mesh_info.mat;
+
+		const GLfloat rows[] = {
+			mat.m11, mat.m12, mat.m13, mat.m14,
+			mat.m21, mat.m22, mat.m23, mat.m24,
+			mat.m31, mat.m32, mat.m33, mat.m34 };
 
-		m.m->draw();
+		mat_ptr = std::copy(std::begin(rows), std::end(rows), mat_ptr);
 	}
 
-	// draw meshes
+	vert_buffer_.unmap();
 
-	prog_mesh_->use();
+	auto draw_instances = [&](bool write_ids)
+		{
+			size_t run_start = 0;
 
-	gl_check(glFrontFace(GL_CCW));
+			while (run_start < num_meshes) {
+				const mesh *m = meshes[run_start]->mesh_info.m;
 
-	for (size_t i = 0; i < num_meshes; i++) {
-		auto sp = meshes[i];
-		assert(sp->type == primitive_info::MESH);
+				size_t run_end = run_start + 1;
+
+				while (run_end < num_meshes && meshes[run_end]->mesh_info.m == m)
+					++run_end;
+
+				const GLsizei count = run_end - run_start;
+
+				if (write_ids) {
+					prog_mesh_id_->set_uniform_i(mesh_id_base_uniform_, next_mesh_id_);
+					next_mesh_id_ = (next_mesh_id_ + count)%255;
+				}
+
+				m->draw_instanced(offset + run_start*mesh::INSTANCE_STRIDE, count);
+				++draw_calls;
+
+				run_start = run_end;
+			}
+		};
+
+	gl_check(glEnable(GL_CULL_FACE));
+
+	if (mesh_outline_mode == mesh_outline::GEOMETRY) {
+		// draw outlines
+
+		prog_mesh_outline_->use();
+
+		gl_check(glFrontFace(GL_CW));
+
+		draw_instances(false);
+
+		// draw meshes
+
+		prog_mesh_->use();
 
-		auto& m = sp->mesh_info;
-		prog_mesh_->set_uniform_mat4("modelview_matrix", m.mat);
+		gl_check(glFrontFace(GL_CCW));
 
-		m.m->draw();
+		draw_instances(false);
+	} else if (gl_state::get_framebuffer() != 0) {
+		// draw meshes and their ids; only meshes write to the id buffer,
+		// so other primitives keep drawing to the first attachment alone
+
+		static const GLenum color_and_id[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+		static const GLenum color_only[] = { GL_COLOR_ATTACHMENT0 };
+
+		prog_mesh_id_->use();
+
+		gl_check(glDrawBuffers(2, color_and_id));
+		draw_instances(true);
+		gl_check(glDrawBuffers(1, color_only));
+	} else {
+		// nowhere to write ids to, draw meshes without outlines
+
+		prog_mesh_->use();
+
+		draw_instances(false);
 	}
 
 	gl_check(glDisable(GL_CULL_FACE));
@@ -926,4 +1225,38 @@ get_proj_modelview()
 	return g_renderer->get_proj_modelview();
 }
 
+void
+end_frame()
+{
+	last_frame_draw_calls = draw_calls;
+	draw_calls = 0;
+}
+
+unsigned
+get_draw_call_count()
+{
+	return last_frame_draw_calls;
+}
+
+void
+set_mesh_outline(mesh_outline mode)
+{
+	mesh_outline_mode = mode;
+}
+
+mesh_outline
+get_mesh_outline()
+{
+	return mesh_outline_mode;
+}
+
+void
+toggle_mesh_outline()
+{
+	mesh_outline_mode =
+		mesh_outline_mode == mesh_outline::GEOMETRY ?
+			mesh_outline::POST_PROCESS :
+			mesh_outline::GEOMETRY;
+}
+
 } }
@@ -103,4 +103,28 @@ end();
 const GLfloat *
 get_proj_modelview();
 
+void
+end_frame();
+
+// draw calls issued by all begin()/end() pairs during the last frame
+unsigned
+get_draw_call_count();
+
+// GEOMETRY draws each mesh a second time, pushed out along its normals.
+// POST_PROCESS draws each mesh once and writes per-instance ids to the
+// second colour attachment of the bound framebuffer (see framebuffer's
+// with_id_buffer), leaving the outline to an edge-detect filter
+enum class mesh_outline { GEOMETRY, POST_PROCESS };
+
+void
+set_mesh_outline(mesh_outline mode);
+
+mesh_outline
+get_mesh_outline();
+
+// switches to the other technique. bound to a key by the platform cores so
+// that release builds can compare the two
+void
+toggle_mesh_outline();
+
 } }
@@ -3,13 +3,20 @@
 #include <unordered_map>
 
 #include <ggl/panic.h>
+#include <ggl/gl.h>
+#include <ggl/gl_check.h>
 #include <ggl/noncopyable.h>
 #include <ggl/texture.h>
+#include <ggl/texture_atlas.h>
 #include <ggl/font.h>
 #include <ggl/sprite_manager.h>
 #include <ggl/program_manager.h>
 #include <ggl/action.h>
 #include <ggl/mesh.h>
+#include <ggl/vertex_array.h>
+#include <ggl/core.h>
+#include <ggl/asset.h>
+#include <ggl/loader.h>
 #include <ggl/resources.h>
 
 namespace ggl { namespace res {
@@ -27,28 +34,136 @@ public:
 		auto it = resource_map_.find(name);
 
 		if (it == std::end(resource_map_)) {
+			auto p = pending_map_.find(name);
+
+			if (p != std::end(pending_map_)) {
+				// its done part moves it to resource_map_
+				loader::complete(p->second.job);
+				return resource_map_[name].get();
+			}
+
 			it = resource_map_.insert(it, std::make_pair(name, static_cast<ImplType *>(this)->load(name)));
 		}
 
 		return it->second.get();
 	}
 
+	// ImplType must provide stage(), run on the loader thread, and
+	// create(), run on the main thread with stage()'s result
+	pending<ResourceType> get_async(const std::string& name)
+	{
+		auto it = resource_map_.find(name);
+
+		if (it != std::end(resource_map_))
+			return pending<ResourceType> { std::make_shared<const ResourceType *>(it->second.get()) };
+
+		auto p = pending_map_.find(name);
+
+		if (p == std::end(pending_map_)) {
+			using staged_type = decltype(ImplType::stage(name));
+
+			auto staged = std::make_shared<staged_type>();
+			auto value = std::make_shared<const ResourceType *>(nullptr);
+
+			auto job = loader::enqueue(
+					[name, staged]
+					{
+						*staged = ImplType::stage(name);
+					},
+					[this, name, staged, value]
+					{
+						auto r = static_cast<ImplType *>(this)->create(name, std::move(*staged));
+						*value = r.get();
+
+						resource_map_.insert(std::make_pair(name, std::move(r)));
+						pending_map_.erase(name);
+					});
+
+			p = pending_map_.insert(p, std::make_pair(name, pending_load { job, value }));
+		}
+
+		return pending<ResourceType> { p->second.value };
+	}
+
 protected:
 	std::unordered_map<std::string, std::unique_ptr<ResourceType>> resource_map_;
+
+	struct pending_load
+	{
+		loader::job_ptr job;
+		std::shared_ptr<const ResourceType *> value;
+	};
+	std::unordered_map<std::string, pending_load> pending_map_;
 };
 
 class texture_manager : public resource_manager<texture, texture_manager>
 {
 public:
+	texture_manager()
+	: residency_ { texture_residency::KEEP_DATA }
+	{ }
+
 	std::unique_ptr<texture> load(const std::string& name)
 	{
-		return std::unique_ptr<texture>(new texture { image(name) });
+		return create(name, stage(name));
+	}
+
+	static std::unique_ptr<image> stage(const std::string& name)
+	{
+		return std::unique_ptr<image>(new image { name });
 	}
 
+	std::unique_ptr<texture> create(const std::string& name, std::unique_ptr<image> im)
+	{
+		std::unique_ptr<texture> tex { new texture { *im } };
+
+		if (residency_ == texture_residency::GL_ONLY)
+			tex->drop_data(name);
+
+		return tex;
+	}
+
+	void set_residency(texture_residency residency)
+	{ residency_ = residency; }
+
 	void load_all();
 	void unload_all();
+
+	memory_usage get_memory_usage() const;
+
+private:
+	texture_residency residency_;
 } *g_texture_manager;
 
+// sprite sheet and font pages. RGBA pages share atlas textures, so sprites
+// and text can be batched together; anything else gets its own texture
+
+class texture_region_manager : private noncopyable
+{
+public:
+	const texture_region *get(const std::string& name);
+	void preload(const std::string& name);
+
+	void load_all();
+	void unload_all();
+
+	memory_usage get_memory_usage() const;
+
+private:
+	const texture_region *add(const std::string& name, const image& im);
+
+	// wide enough for the 1024x1024 sprite sheet and two 512x512 font pages
+	// side by side with their gutters, so the shipped pages all share one
+	// atlas. narrower if the GL can't do that (2048 is the GLES 3 minimum)
+	static const unsigned ATLAS_WIDTH = 2560;
+	static const unsigned ATLAS_HEIGHT = 2048;
+
+	std::unordered_map<std::string, std::unique_ptr<texture_region>> region_map_;
+	std::unordered_map<std::string, loader::job_ptr> pending_map_;
+	std::vector<std::unique_ptr<texture_atlas>> atlases_;
+	std::vector<std::unique_ptr<texture>> textures_; // pages that don't fit in an atlas
+} *g_texture_region_manager;
+
 class font_manager : public resource_manager<font, font_manager>
 {
 public:
@@ -75,8 +190,26 @@ public:
 		return std::unique_ptr<mesh>(new mesh { name });
 	}
 
+	// reads the whole file, unless it's already in memory
+	static std::unique_ptr<asset> stage(const std::string& name)
+	{
+		auto a = g_core->get_asset(name);
+
+		if (!a->data())
+			a.reset(new buffer_asset { a->read_all() });
+
+		return a;
+	}
+
+	std::unique_ptr<mesh> create(const std::string& name, std::unique_ptr<asset> a)
+	{
+		return std::unique_ptr<mesh>(new mesh { name, *a });
+	}
+
 	void load_all();
 	void unload_all();
+
+	memory_usage get_memory_usage() const;
 } *g_mesh_manager;
 
 sprite_manager *g_sprite_manager;
@@ -96,6 +229,135 @@ texture_manager::unload_all()
 		kv.second->unload();
 }
 
+memory_usage
+texture_manager::get_memory_usage() const
+{
+	memory_usage usage { "textures", resource_map_.size(), 0, 0 };
+
+	for (auto& kv : resource_map_) {
+		usage.data_bytes += kv.second->get_data_size();
+		usage.gl_bytes += kv.second->get_gl_size();
+	}
+
+	return usage;
+}
+
+const texture_region *
+texture_region_manager::get(const std::string& name)
+{
+	auto it = region_map_.find(name);
+
+	if (it != std::end(region_map_))
+		return it->second.get();
+
+	auto p = pending_map_.find(name);
+
+	if (p != std::end(pending_map_)) {
+		loader::complete(p->second);
+		return region_map_[name].get();
+	}
+
+	return add(name, image { name });
+}
+
+void
+texture_region_manager::preload(const std::string& name)
+{
+	if (region_map_.count(name) || pending_map_.count(name))
+		return;
+
+	auto im = std::make_shared<std::unique_ptr<image>>();
+
+	pending_map_[name] = loader::enqueue(
+				[name, im]
+				{
+					im->reset(new image { name });
+				},
+				[this, name, im]
+				{
+					add(name, **im);
+					pending_map_.erase(name);
+				});
+}
+
+const texture_region *
+texture_region_manager::add(const std::string& name, const image& im)
+{
+	std::unique_ptr<texture_region> region { new texture_region {} };
+
+	auto add_to_atlas = [&]
+		{
+			for (auto& atlas : atlases_) {
+				if (atlas->add(im, region->origin)) {
+					region->tex = atlas->get_texture();
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+	if (!add_to_atlas() && im.type == pixel_type::RGB_ALPHA) {
+		GLint max_size;
+		gl_check(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size));
+
+		const unsigned atlas_width = static_cast<unsigned>(max_size) < ATLAS_WIDTH ? max_size : ATLAS_WIDTH;
+
+		if (im.width + 2*texture_atlas::GUTTER <= atlas_width && im.height + 2*texture_atlas::GUTTER <= ATLAS_HEIGHT) {
+			atlases_.emplace_back(new texture_atlas { atlas_width, ATLAS_HEIGHT, pixel_type::RGB_ALPHA });
+			add_to_atlas();
+		}
+	}
+
+	if (!region->tex) {
+		textures_.emplace_back(new texture { im });
+		region->tex = textures_.back().get();
+		region->origin = vec2i { 0, 0 };
+	}
+
+	return region_map_.insert(std::make_pair(name, std::move(region))).first->second.get();
+}
+
+void
+texture_region_manager::load_all()
+{
+	for (auto& atlas : atlases_)
+		atlas->get_texture()->load();
+
+	for (auto& tex : textures_)
+		tex->load();
+}
+
+void
+texture_region_manager::unload_all()
+{
+	for (auto& atlas : atlases_)
+		atlas->get_texture()->unload();
+
+	for (auto& tex : textures_)
+		tex->unload();
+}
+
+memory_usage
+texture_region_manager::get_memory_usage() const
+{
+	memory_usage usage { "pages", region_map_.size(), 0, 0 };
+
+	auto add_texture = [&](const texture *tex)
+		{
+			usage.data_bytes += tex->get_data_size();
+			usage.gl_bytes += tex->get_gl_size();
+		};
+
+	for (auto& atlas : atlases_)
+		add_texture(atlas->get_texture());
+
+	for (auto& tex : textures_)
+		add_texture(tex.get());
+
+	return usage;
+}
+
 void
 mesh_manager::load_all()
 {
@@ -110,11 +372,25 @@ mesh_manager::unload_all()
 		kv.second->unload();
 }
 
+memory_usage
+mesh_manager::get_memory_usage() const
+{
+	memory_usage usage { "meshes", resource_map_.size(), 0, 0 };
+
+	for (auto& kv : resource_map_) {
+		usage.data_bytes += kv.second->get_data_size();
+		usage.gl_bytes += kv.second->get_gl_size();
+	}
+
+	return usage;
+}
+
 } // (anonymous namespace)
 
 void init()
 {
 	g_texture_manager = new texture_manager;
+	g_texture_region_manager = new texture_region_manager;
 	g_font_manager = new font_manager;
 	g_sprite_manager = new sprite_manager;
 	g_program_manager = new program_manager;
@@ -124,12 +400,36 @@ void init()
 	g_program_manager->load_programs("shaders/default.xml");
 }
 
+void
+set_texture_residency(texture_residency residency)
+{
+	g_texture_manager->set_residency(residency);
+}
+
 const texture *
 get_texture(const std::string& name)
 {
 	return g_texture_manager->get(name);
 }
 
+pending<texture>
+get_texture_async(const std::string& name)
+{
+	return g_texture_manager->get_async(name);
+}
+
+const texture_region *
+get_texture_region(const std::string& name)
+{
+	return g_texture_region_manager->get(name);
+}
+
+void
+preload_texture_region(const std::string& name)
+{
+	g_texture_region_manager->preload(name);
+}
+
 const font *
 get_font(const std::string& name)
 {
@@ -160,6 +460,12 @@ get_mesh(const std::string& name)
 	return g_mesh_manager->get(name);
 }
 
+pending<mesh>
+get_mesh_async(const std::string& name)
+{
+	return g_mesh_manager->get_async(name);
+}
+
 void
 load_sprite_sheet(const std::string& path)
 {
@@ -176,8 +482,10 @@ void
 unload_gl_resources()
 {
 	g_texture_manager->unload_all();
+	g_texture_region_manager->unload_all();
 	g_program_manager->unload_all();
 	g_mesh_manager->unload_all();
+	vertex_buffer_base::unload_all();
 }
 
 void
@@ -185,7 +493,18 @@ load_gl_resources()
 {
 	g_mesh_manager->load_all();
 	g_texture_manager->load_all();
+	g_texture_region_manager->load_all();
 	g_program_manager->load_all();
+	vertex_buffer_base::load_all();
+}
+
+std::vector<memory_usage>
+get_memory_usage()
+{
+	return {
+		g_texture_manager->get_memory_usage(),
+		g_texture_region_manager->get_memory_usage(),
+		g_mesh_manager->get_memory_usage() };
 }
 
 } }
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace ggl {
 class texture;
@@ -10,16 +11,57 @@ class sprite;
 class action;
 class program;
 class mesh;
+struct texture_region;
 }
 
 namespace ggl { namespace res {
 
+// a resource being loaded in the background. get() is nullptr until the
+// loader has finished it; the synchronous get_*() functions finish it
+// right away instead
+
+template <typename T>
+class pending
+{
+public:
+	explicit pending(std::shared_ptr<const T *> value)
+	: value_ { std::move(value) }
+	{ }
+
+	bool ready() const
+	{ return *value_ != nullptr; }
+
+	const T *get() const
+	{ return *value_; }
+
+private:
+	std::shared_ptr<const T *> value_;
+};
+
 void
 init();
 
+// whether textures loaded by name keep a copy of their pixels after
+// upload, or decode their image again when GL resources are reloaded.
+// sprite sheet and font pages always keep theirs
+enum class texture_residency { KEEP_DATA, GL_ONLY };
+
+void
+set_texture_residency(texture_residency residency);
+
 const texture *
 get_texture(const std::string& name);
 
+pending<texture>
+get_texture_async(const std::string& name);
+
+// for sprite sheet and font pages, which may be packed into a shared texture
+const texture_region *
+get_texture_region(const std::string& name);
+
+void
+preload_texture_region(const std::string& name);
+
 const font *
 get_font(const std::string& name);
 
@@ -32,6 +74,9 @@ get_program(const std::string& name);
 const mesh *
 get_mesh(const std::string& name);
 
+pending<mesh>
+get_mesh_async(const std::string& name);
+
 std::unique_ptr<action>
 get_action(const std::string& name);
 
@@ -47,4 +92,15 @@ unload_gl_resources();
 void
 load_gl_resources();
 
+struct memory_usage
+{
+	const char *manager;
+	size_t count;
+	size_t data_bytes; // in memory
+	size_t gl_bytes; // estimated, in the GL
+};
+
+std::vector<memory_usage>
+get_memory_usage();
+
 } }
@@ -1,5 +1,8 @@
 #include <ggl/asset.h>
 #include <ggl/panic.h>
+#include <ggl/gl_state.h>
+#include <ggl/render.h>
+#include <ggl/loader.h>
 
 #include <ggl/sdl/asset.h>
 #include <ggl/sdl/core.h>
@@ -10,12 +13,20 @@
 #include <cstring>
 #include <cerrno>
 
+#include <unistd.h>
+
 #include <SDL.h>
 #include <GL/glew.h>
 #include <physfs.h>
 
 namespace ggl { namespace sdl {
 
+namespace {
+
+const char *BUNDLE_PATH = "assets.bundle";
+
+}
+
 core::core(app& a, int width, int height, const char *caption, bool fullscreen)
 : ggl::core { a }
 , width_ { width }
@@ -59,10 +70,17 @@ core::core(app& a, int width, int height, const char *caption, bool fullscreen)
 
 	PHYSFS_mount(".", nullptr, 1);
 	PHYSFS_mount("assets.zip", nullptr, 1);
+
+	// uncompressed asset bundle
+
+	if (access(BUNDLE_PATH, R_OK) == 0)
+		bundle_.reset(new bundle(BUNDLE_PATH));
 }
 
 core::~core()
 {
+	loader::shutdown();
+
 	// OpenAL
 
 	alcMakeContextCurrent(nullptr);
@@ -89,10 +107,13 @@ core::run()
 
 	for (;;) {
 		float t = now();
+		loader::poll();
 		app_.update_and_render(t - last_update);
 		last_update = t;
 
 		SDL_GL_SwapBuffers();
+		gl_state::end_frame();
+		render::end_frame();
 
 		if (!poll_events())
 			break;
@@ -166,6 +187,10 @@ core::on_key_down(int keysym)
 		case SDLK_SPACE:
 			dpad_button_down_event_.notify(dpad_button::BUTTON2);
 			break;
+
+		case SDLK_o:
+			render::toggle_mesh_outline();
+			break;
 	}
 }
 
@@ -202,6 +227,11 @@ core::on_key_up(int keysym)
 std::unique_ptr<ggl::asset>
 core::get_asset(const std::string& path) const
 {
+	if (bundle_) {
+		if (auto a = bundle_->get_asset(path))
+			return a;
+	}
+
 	return std::unique_ptr<ggl::asset>(new asset(path));
 }
 
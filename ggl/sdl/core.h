@@ -1,4 +1,5 @@
 #include <ggl/core.h>
+#include <ggl/bundle.h>
 
 #include <AL/alc.h>
 #include <AL/al.h>
@@ -35,6 +36,8 @@ private:
 
 	ALCdevice *al_device_;
 	ALCcontext *al_context_;
+
+	std::unique_ptr<bundle> bundle_; // looked up before PhysFS, if present
 };
 
 } }
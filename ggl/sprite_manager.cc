@@ -4,6 +4,7 @@
 #include <ggl/core.h>
 #include <ggl/asset.h>
 #include <ggl/resources.h>
+#include <ggl/texture_atlas.h>
 #include <ggl/sprite.h>
 #include <ggl/sprite_manager.h>
 
@@ -23,21 +24,21 @@ sprite_manager::get(const std::string& name) const
 void
 sprite_manager::load_sprite_sheet(const std::string& path)
 {
-	auto xml = g_core->get_asset(path)->read_all();
+	auto asset = g_core->get_asset(path);
 
 	TiXmlDocument doc;
-	doc.Parse(&xml[0]);
+	doc.Parse(asset->read_text());
 
 	auto root_el = doc.RootElement();
 
 	// textures
 
-	std::vector<const ggl::texture *> textures;
+	std::vector<const texture_region *> pages;
 
 	if (auto textures_el  = root_el->FirstChildElement("textures")) {
 		for (auto node = textures_el->FirstChild(); node; node = node->NextSibling()) {
 			if (auto el = node->ToElement())
-				textures.push_back(res::get_texture(el->Attribute("path")));
+				pages.push_back(res::get_texture_region(el->Attribute("path")));
 		}
 	}
 
@@ -60,7 +61,7 @@ sprite_manager::load_sprite_sheet(const std::string& path)
 			int w = atoi(el->Attribute("w"));
 			int h = atoi(el->Attribute("h"));
 
-			auto sp = std::unique_ptr<sprite>(new sprite(textures[tex], u, v, w, h));
+			auto sp = std::unique_ptr<sprite>(new sprite(pages[tex]->tex, pages[tex]->origin.x + u, pages[tex]->origin.y + v, w, h));
 			sprite_map_.insert(std::make_pair(name, std::move(sp)));
 		}
 	}
@@ -5,6 +5,7 @@
 #include <ggl/panic.h>
 #include <ggl/texture.h>
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 
 namespace ggl {
 
@@ -53,8 +54,35 @@ texture::texture(const image& im)
 , height { next_power_of_2(orig_height) }
 , type { im.type }
 , id_ { 0 }
-, data_(width*height*pixel_size())
 {
+	set_data(im);
+	load();
+}
+
+texture::texture(unsigned width, unsigned height, pixel_type type)
+: orig_width { width }
+, width { next_power_of_2(orig_width) }
+, orig_height { height }
+, height { next_power_of_2(orig_height) }
+, type { type }
+, id_ { 0 }
+, data_(this->width*this->height*pixel_size())
+{
+	load();
+}
+
+texture::~texture()
+{
+	unload();
+}
+
+void
+texture::set_data(const image& im)
+{
+	assert(im.width == orig_width && im.height == orig_height && im.type == type);
+
+	data_.resize(width*height*pixel_size());
+
 	const uint8_t *src = &im.data[(im.height - 1)*im.row_stride()];
 	uint8_t *dest = &data_[0];
 
@@ -63,25 +91,31 @@ texture::texture(const image& im)
 		src -= im.row_stride();
 		dest += row_stride();
 	}
-
-	load();
 }
 
-texture::~texture()
+void
+texture::drop_data(const std::string& source_path)
 {
-	unload();
+	source_path_ = source_path;
+	std::vector<uint8_t>().swap(data_);
 }
 
 void
 texture::bind() const
 {
-	gl_check(glBindTexture(GL_TEXTURE_2D, id_));
+	gl_state::bind_texture(id_);
 }
 
 void
 texture::load()
 {
 	assert(id_ == 0);
+
+	const bool reload = data_.empty() && !source_path_.empty();
+
+	if (reload)
+		set_data(image { source_path_ });
+
 	gl_check(glGenTextures(1, &id_));
 
 	bind();
@@ -95,11 +129,47 @@ texture::load()
 	gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 	gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 	gl_check(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+
+	if (reload)
+		std::vector<uint8_t>().swap(data_);
+}
+
+void
+texture::copy_image(const image& im, unsigned x, unsigned y)
+{
+	assert(im.type == type);
+	assert(x + im.width <= width && y + im.height <= height);
+	assert(source_path_.empty());
+
+	// rows are stored bottom to top
+
+	const unsigned first_row = height - y - im.height;
+
+	const uint8_t *src = &im.data[(im.height - 1)*im.row_stride()];
+	uint8_t *dest = &data_[first_row*row_stride() + x*pixel_size()];
+
+	for (unsigned i = 0; i < im.height; i++) {
+		std::copy(src, src + im.row_stride(), dest);
+		src -= im.row_stride();
+		dest += row_stride();
+	}
+
+	if (id_) {
+		bind();
+
+		const GLint format = color_type_to_pixel_format(type);
+
+		gl_check(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		gl_check(glPixelStorei(GL_UNPACK_ROW_LENGTH, width));
+		gl_check(glTexSubImage2D(GL_TEXTURE_2D, 0, x, first_row, im.width, im.height, format, GL_UNSIGNED_BYTE, &data_[first_row*row_stride() + x*pixel_size()]));
+		gl_check(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+	}
 }
 
 void
 texture::unload()
 {
+	gl_state::forget_texture(id_);
 	gl_check(glDeleteTextures(1, &id_));
 	id_ = 0;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <ggl/gl.h>
 #include <ggl/noncopyable.h>
 #include <ggl/image.h>
@@ -10,8 +12,13 @@ class texture : private noncopyable
 {
 public:
 	texture(const image& pm);
+	texture(unsigned width, unsigned height, pixel_type type); // blank
 	~texture();
 
+	// copies im into the texture with its top-left corner at (x, y),
+	// measured from the top like sprite coordinates
+	void copy_image(const image& im, unsigned x, unsigned y);
+
 	void bind() const;
 
 	unsigned row_stride() const
@@ -23,13 +30,28 @@ public:
 	void load();
 	void unload();
 
+	// frees the CPU copy of the pixels. load() then decodes source_path
+	// again, and frees the copy once uploaded. only for textures made
+	// from a single image
+	void drop_data(const std::string& source_path);
+
+	// bytes held in memory and in the GL
+	size_t get_data_size() const
+	{ return data_.size(); }
+
+	size_t get_gl_size() const
+	{ return id_ ? width*height*pixel_size() : 0; }
+
 	unsigned orig_width, width;
 	unsigned orig_height, height;
 	pixel_type type;
 
 private:
+	void set_data(const image& im);
+
 	GLuint id_;
 	std::vector<uint8_t> data_;
+	std::string source_path_; // empty unless data_ was dropped
 
 	friend class framebuffer;
 };
@@ -0,0 +1,74 @@
+#include <algorithm>
+
+#include <ggl/texture.h>
+#include <ggl/texture_atlas.h>
+
+namespace ggl {
+
+texture_atlas::texture_atlas(unsigned width, unsigned height, pixel_type type)
+: shelf_x_ { 0 }
+, shelf_y_ { 0 }
+, shelf_height_ { 0 }
+, texture_ { new texture(width, height, type) }
+{ }
+
+texture_atlas::~texture_atlas() = default;
+
+bool
+texture_atlas::add(const image& im, vec2i& origin)
+{
+	if (im.type != texture_->type)
+		return false;
+
+	// each image gets a gutter with its edge pixels repeated, so linear
+	// filtering at the edges doesn't pull in its neighbours (or, since the
+	// atlas wraps with GL_REPEAT, the image on the opposite side)
+
+	const unsigned padded_width = im.width + 2*GUTTER;
+	const unsigned padded_height = im.height + 2*GUTTER;
+
+	unsigned x = shelf_x_, y = shelf_y_, shelf_height = shelf_height_;
+
+	if (x + padded_width > texture_->width) {
+		// start a new shelf
+		x = 0;
+		y += shelf_height;
+		shelf_height = 0;
+	}
+
+	if (x + padded_width > texture_->width || y + padded_height > texture_->height)
+		return false;
+
+	image padded { padded_width, padded_height, im.type };
+
+	const unsigned pixel_size = im.pixel_size();
+
+	for (unsigned i = 0; i < padded_height; i++) {
+		const unsigned src_row = std::min(i < GUTTER ? 0 : i - GUTTER, im.height - 1);
+
+		const uint8_t *src = &im.data[src_row*im.row_stride()];
+		uint8_t *dest = &padded.data[i*padded.row_stride()];
+
+		for (unsigned j = 0; j < GUTTER; j++)
+			std::copy(src, src + pixel_size, dest + j*pixel_size);
+
+		std::copy(src, src + im.row_stride(), dest + GUTTER*pixel_size);
+
+		const uint8_t *src_last = src + im.row_stride() - pixel_size;
+
+		for (unsigned j = GUTTER + im.width; j < padded_width; j++)
+			std::copy(src_last, src_last + pixel_size, dest + j*pixel_size);
+	}
+
+	texture_->copy_image(padded, x, y);
+
+	origin = vec2i { static_cast<int>(x + GUTTER), static_cast<int>(y + GUTTER) };
+
+	shelf_x_ = x + padded_width;
+	shelf_y_ = y;
+	shelf_height_ = std::max(shelf_height, padded_height);
+
+	return true;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+
+#include <ggl/noncopyable.h>
+#include <ggl/image.h>
+#include <ggl/vec2.h>
+
+namespace ggl {
+
+class texture;
+
+// an image placed in a (possibly shared) texture. sprite coordinates on
+// the image must be offset by origin
+
+struct texture_region
+{
+	const texture *tex;
+	vec2i origin;
+};
+
+// packs images into a single texture in rows ("shelves"), so sprites from
+// different sprite sheets and fonts can be drawn in one batch
+
+class texture_atlas : private noncopyable
+{
+public:
+	// pixels around each image, filled with copies of its edges
+	static const unsigned GUTTER = 1;
+
+	texture_atlas(unsigned width, unsigned height, pixel_type type);
+	~texture_atlas();
+
+	// false if im doesn't fit or has a different pixel type
+	bool add(const image& im, vec2i& origin);
+
+	texture *get_texture() const
+	{ return texture_.get(); }
+
+private:
+	unsigned shelf_x_, shelf_y_, shelf_height_;
+	std::unique_ptr<texture> texture_;
+};
+
+}
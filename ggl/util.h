@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ggl/gl.h>
+#include <ggl/gl_state.h>
 
 namespace ggl {
 
@@ -9,13 +10,12 @@ struct enable_blend
 {
 	enable_blend()
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(SFactor, DFactor);
+		gl_state::enable_blend(SFactor, DFactor);
 	}
 
 	~enable_blend()
 	{
-		glDisable(GL_BLEND);
+		gl_state::disable_blend();
 	}
 };
 
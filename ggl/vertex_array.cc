@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <vector>
+
+#include <ggl/vertex_array.h>
+
+namespace ggl {
+
+namespace {
+
+std::vector<vertex_buffer_base *> live_vertex_buffers;
+
+} // (anonymous namespace)
+
+vertex_buffer_base::vertex_buffer_base()
+{
+	live_vertex_buffers.push_back(this);
+}
+
+vertex_buffer_base::~vertex_buffer_base()
+{
+	live_vertex_buffers.erase(std::find(std::begin(live_vertex_buffers), std::end(live_vertex_buffers), this));
+}
+
+void
+vertex_buffer_base::load_all()
+{
+	for (auto p : live_vertex_buffers)
+		p->load();
+}
+
+void
+vertex_buffer_base::unload_all()
+{
+	for (auto p : live_vertex_buffers)
+		p->unload();
+}
+
+}
@@ -3,10 +3,16 @@
 // this is a disgrace.
 
 #include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <memory>
 
 #include <ggl/gl.h>
 #include <ggl/gl_vertex_array.h>
+#include <ggl/gl_buffer.h>
+#include <ggl/noncopyable.h>
 #include <ggl/resources.h>
 #include <ggl/gl_check.h>
 #include <ggl/rgba.h>
@@ -62,15 +68,24 @@ struct gltype_to_glenum<GLfloat>
 	static const GLenum type = GL_FLOAT;
 };
 
+// base is either client memory or an offset into the bound GL_ARRAY_BUFFER
+inline const GLvoid *
+attrib_pointer(const GLvoid *base, size_t offset)
+{
+	return reinterpret_cast<const GLvoid *>(reinterpret_cast<uintptr_t>(base) + offset);
+}
+
 template <typename Vertex>
 struct vertex_traits;
 
 template <typename VertexType, int VertexSize>
 struct vertex_traits<vertex_flat<VertexType, VertexSize>>
 {
-	static void enable_vertex_attribs(const vertex_flat<VertexType, VertexSize> *p)
+	using vertex = vertex_flat<VertexType, VertexSize>;
+
+	static void enable_vertex_attribs(const GLvoid *base)
 	{
-		gl_check(glVertexAttribPointer(0, VertexSize, gltype_to_glenum<VertexType>::type, GL_FALSE, sizeof(*p), p->position));
+		gl_check(glVertexAttribPointer(0, VertexSize, gltype_to_glenum<VertexType>::type, GL_FALSE, sizeof(vertex), attrib_pointer(base, offsetof(vertex, position))));
 		gl_check(glEnableVertexAttribArray(0));
 	}
 
@@ -83,12 +98,14 @@ struct vertex_traits<vertex_flat<VertexType, VertexSize>>
 template <typename VertexType, int VertexSize, typename TexCoordType, int TexCoordSize>
 struct vertex_traits<vertex_texcoord<VertexType, VertexSize, TexCoordType, TexCoordSize>>
 {
-	static void enable_vertex_attribs(const vertex_texcoord<VertexType, VertexSize, TexCoordType, TexCoordSize> *p)
+	using vertex = vertex_texcoord<VertexType, VertexSize, TexCoordType, TexCoordSize>;
+
+	static void enable_vertex_attribs(const GLvoid *base)
 	{
-		gl_check(glVertexAttribPointer(0, VertexSize, gltype_to_glenum<VertexType>::type, GL_FALSE, sizeof(*p), p->position));
+		gl_check(glVertexAttribPointer(0, VertexSize, gltype_to_glenum<VertexType>::type, GL_FALSE, sizeof(vertex), attrib_pointer(base, offsetof(vertex, position))));
 		gl_check(glEnableVertexAttribArray(0));
 
-		gl_check(glVertexAttribPointer(1, TexCoordSize, gltype_to_glenum<TexCoordType>::type, GL_FALSE, sizeof(*p), p->texcoord));
+		gl_check(glVertexAttribPointer(1, TexCoordSize, gltype_to_glenum<TexCoordType>::type, GL_FALSE, sizeof(vertex), attrib_pointer(base, offsetof(vertex, texcoord))));
 		gl_check(glEnableVertexAttribArray(1));
 	}
 
@@ -132,4 +149,123 @@ using vertex_array_flat = vertex_array<vertex_flat<VertexType, VertexSize>>;
 template <typename VertexType, int VertexSize, typename TexCoordType, int TexCoordSize>
 using vertex_array_texcoord = vertex_array<vertex_texcoord<VertexType, VertexSize, TexCoordType, TexCoordSize>>;
 
+// vertex buffers keep track of each other so their GL objects can be
+// recreated when the context is lost (see res::unload_gl_resources and
+// res::load_gl_resources)
+
+class vertex_buffer_base : private noncopyable
+{
+public:
+	vertex_buffer_base();
+	virtual ~vertex_buffer_base();
+
+	virtual void load() = 0;
+	virtual void unload() = 0;
+
+	static void load_all();
+	static void unload_all();
+};
+
+// same as vertex_array, but drawn from a buffer object. contents only reach
+// the GPU on upload(), so unchanged geometry costs nothing per frame. the
+// client copy is kept, and sent again by load().
+
+template <typename VertexType>
+class vertex_buffer : public std::vector<VertexType>, public vertex_buffer_base
+{
+public:
+	vertex_buffer(GLenum usage = GL_STATIC_DRAW)
+	: usage_ { usage }
+	, buffer_size_ { 0 }
+	, draw_size_ { 0 }
+	{
+		create_gl_objects();
+	}
+
+	vertex_buffer(std::initializer_list<VertexType> l, GLenum usage = GL_STATIC_DRAW)
+	: vertex_buffer { usage }
+	{
+		this->assign(l);
+		upload();
+	}
+
+	void load() override
+	{
+		create_gl_objects();
+		upload();
+	}
+
+	void unload() override
+	{
+		vao_.reset();
+		buffer_.reset();
+	}
+
+	void upload()
+	{
+		upload(0, this->size());
+	}
+
+	// upload [first, first + count); everything else is assumed unchanged
+	void upload(size_t first, size_t count)
+	{
+		assert(first + count <= this->size());
+
+		buffer_->bind();
+
+		if (this->size() > buffer_size_ || (first == 0 && count == this->size())) {
+			// reallocate (orphaning the old storage, so we don't wait for
+			// draws still using it) and send everything
+
+			buffer_size_ = std::max(buffer_size_, this->capacity());
+			buffer_->buffer_data(buffer_size_*sizeof(VertexType), nullptr, usage_);
+
+			first = 0;
+			count = this->size();
+		}
+
+		if (count)
+			buffer_->buffer_sub_data(first*sizeof(VertexType), count*sizeof(VertexType), &(*this)[first]);
+
+		buffer_->unbind();
+
+		draw_size_ = this->size();
+	}
+
+	void draw(GLenum mode) const
+	{
+		if (draw_size_) {
+			vao_->bind();
+			gl_check(glDrawArrays(mode, 0, draw_size_));
+			gl_vertex_array::unbind();
+		}
+	}
+
+private:
+	void create_gl_objects()
+	{
+		buffer_.reset(new gl_buffer(GL_ARRAY_BUFFER));
+		vao_.reset(new gl_vertex_array);
+		buffer_size_ = 0;
+
+		vao_->bind();
+		buffer_->bind();
+		detail::vertex_traits<VertexType>::enable_vertex_attribs(nullptr);
+		gl_vertex_array::unbind();
+		buffer_->unbind();
+	}
+
+	std::unique_ptr<gl_buffer> buffer_;
+	std::unique_ptr<gl_vertex_array> vao_;
+	GLenum usage_;
+	size_t buffer_size_; // in vertices
+	size_t draw_size_; // as of last upload
+};
+
+template <typename VertexType, int VertexSize>
+using vertex_buffer_flat = vertex_buffer<vertex_flat<VertexType, VertexSize>>;
+
+template <typename VertexType, int VertexSize, typename TexCoordType, int TexCoordSize>
+using vertex_buffer_texcoord = vertex_buffer<vertex_texcoord<VertexType, VertexSize, TexCoordType, TexCoordSize>>;
+
 } // ggl
@@ -1,5 +1,6 @@
 #include <ggl/gl.h>
 #include <ggl/gl_check.h>
+#include <ggl/gl_state.h>
 #include <ggl/core.h>
 #include <ggl/window.h>
 
@@ -13,7 +14,7 @@ void
 window::bind() const
 {
 	gl_check(glViewport(0, 0, width_, height_));
-	gl_check(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+	gl_state::bind_framebuffer(0);
 }
 
 }